@@ -0,0 +1,103 @@
+/**************************************************************************/
+/*  param_snapshot.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef PARAM_SNAPSHOT_H
+#define PARAM_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Parameter block shared by a resource (writer) and any number of audio-thread readers.
+// Setters modify edit() and call publish(); readers copy one consistent block per mix/process call
+// with read(). It is a seqlock over relaxed atomic words: the writer never waits, and a reader that
+// overlaps a write keeps its previous snapshot instead of spinning, so it never waits either.
+// Writes must come from one thread at a time (the main thread, through the setters).
+template <typename T>
+class ParamSnapshot {
+	static_assert(std::is_trivially_copyable<T>::value, "ParamSnapshot needs a trivially copyable block.");
+
+	static constexpr uint32_t WORD_COUNT = (sizeof(T) + 3) / 4;
+	static constexpr int READ_ATTEMPTS = 4;
+
+	T staged = {}; // Writer copy
+	std::atomic<uint32_t> sequence{ 0 }; // Odd while a write is in progress
+	std::atomic<uint32_t> words[WORD_COUNT] = {};
+
+public:
+	ParamSnapshot() { publish(); }
+
+	// Writer side
+	const T &get() const { return staged; }
+	T &edit() { return staged; }
+
+	void publish() {
+		uint32_t packed[WORD_COUNT] = {};
+		memcpy(packed, &staged, sizeof(T));
+
+		uint32_t seq = sequence.load(std::memory_order_relaxed);
+		sequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (uint32_t i = 0; i < WORD_COUNT; i++) {
+			words[i].store(packed[i], std::memory_order_relaxed);
+		}
+		sequence.store(seq + 2, std::memory_order_release);
+	}
+
+	// Reader side: returns false (r_snapshot untouched) if every attempt overlapped a write
+	bool read(T &r_snapshot) const {
+		uint32_t packed[WORD_COUNT];
+		for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+			uint32_t seq = sequence.load(std::memory_order_acquire);
+			if (seq & 1) {
+				continue;
+			}
+			for (uint32_t i = 0; i < WORD_COUNT; i++) {
+				packed[i] = words[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (sequence.load(std::memory_order_relaxed) == seq) {
+				memcpy(&r_snapshot, packed, sizeof(T));
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Changes every time a new block is published
+	uint32_t get_version() const { return sequence.load(std::memory_order_acquire) >> 1; }
+};
+
+// Per-block linear smoothing: each block ramps from where the last one ended to the new target,
+// so a parameter change spreads over one mix block instead of stepping between two samples.
+class ParamRamp {
+	float current = 0.0f;
+	bool primed = false;
+
+public:
+	void reset(float p_value) {
+		current = p_value;
+		primed = true;
+	}
+
+	// Returns the start value and sets the per-sample step towards p_target over p_frames
+	float begin(float p_target, int p_frames, float &r_step) {
+		if (!primed || p_frames <= 0) {
+			reset(p_target);
+		}
+		float start = current;
+		r_step = p_frames > 0 ? (p_target - start) / p_frames : 0.0f;
+		current = p_target;
+		return start;
+	}
+
+	float get_value() const { return current; }
+};
+
+#endif // PARAM_SNAPSHOT_H
@@ -0,0 +1,107 @@
+/**************************************************************************/
+/*  spsc_ring.h                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+// Lock-free single-producer / single-consumer ring of trivially copyable values.
+// One thread may write and one other thread may read concurrently; resize() and reset()
+// must only be called while neither side is active. Capacity is rounded up to a power of two.
+template <typename T>
+class SPSCRing {
+	T *data = nullptr;
+	uint32_t capacity = 0;
+	uint32_t mask = 0;
+
+	// Free-running positions; the difference is the fill level
+	alignas(64) std::atomic<uint32_t> write_pos{ 0 };
+	alignas(64) std::atomic<uint32_t> read_pos{ 0 };
+
+public:
+	SPSCRing() {}
+	~SPSCRing() { delete[] data; }
+
+	SPSCRing(const SPSCRing &) = delete;
+	SPSCRing &operator=(const SPSCRing &) = delete;
+
+	void resize(uint32_t p_min_capacity) {
+		uint32_t new_capacity = 1;
+		while (new_capacity < p_min_capacity) {
+			new_capacity <<= 1;
+		}
+
+		delete[] data;
+		data = new T[new_capacity]();
+		capacity = new_capacity;
+		mask = new_capacity - 1;
+		reset();
+	}
+
+	void reset() {
+		write_pos.store(0, std::memory_order_relaxed);
+		read_pos.store(0, std::memory_order_relaxed);
+	}
+
+	uint32_t get_capacity() const { return capacity; }
+
+	// Producer side
+	uint32_t available_write() const {
+		return capacity - (write_pos.load(std::memory_order_relaxed) - read_pos.load(std::memory_order_acquire));
+	}
+
+	// Writes up to p_count values and returns how many fit; never blocks
+	uint32_t write(const T *p_src, uint32_t p_count) {
+		uint32_t w = write_pos.load(std::memory_order_relaxed);
+		uint32_t free_count = capacity - (w - read_pos.load(std::memory_order_acquire));
+		uint32_t count = p_count < free_count ? p_count : free_count;
+
+		uint32_t start = w & mask;
+		uint32_t first = count < capacity - start ? count : capacity - start;
+		memcpy(data + start, p_src, first * sizeof(T));
+		memcpy(data, p_src + first, (count - first) * sizeof(T));
+
+		write_pos.store(w + count, std::memory_order_release);
+		return count;
+	}
+
+	// Consumer side
+	uint32_t available_read() const {
+		return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_relaxed);
+	}
+
+	// Reads up to p_count values and returns how many were available; never blocks
+	uint32_t read(T *p_dst, uint32_t p_count) {
+		uint32_t r = read_pos.load(std::memory_order_relaxed);
+		uint32_t used = write_pos.load(std::memory_order_acquire) - r;
+		uint32_t count = p_count < used ? p_count : used;
+
+		uint32_t start = r & mask;
+		uint32_t first = count < capacity - start ? count : capacity - start;
+		memcpy(p_dst, data + start, first * sizeof(T));
+		memcpy(p_dst + first, data, (count - first) * sizeof(T));
+
+		read_pos.store(r + count, std::memory_order_release);
+		return count;
+	}
+
+	// Drops up to p_count values without copying them
+	uint32_t skip(uint32_t p_count) {
+		uint32_t r = read_pos.load(std::memory_order_relaxed);
+		uint32_t used = write_pos.load(std::memory_order_acquire) - r;
+		uint32_t count = p_count < used ? p_count : used;
+		read_pos.store(r + count, std::memory_order_release);
+		return count;
+	}
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,54 @@
+/**************************************************************************/
+/*  triple_buffer.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free triple buffer: one writer publishes complete values, one reader always sees the
+// most recently published one. Neither side ever waits. The slots themselves are owned by the
+// caller (typically pointers to preallocated arrays) and are filled through get_slot() at setup.
+template <typename T>
+class TripleBuffer {
+	static constexpr uint32_t INDEX_MASK = 3;
+	static constexpr uint32_t FRESH_BIT = 4;
+
+	T slots[3] = {};
+	uint32_t back = 0; // Writer-owned
+	uint32_t front = 2; // Reader-owned
+	std::atomic<uint32_t> middle{ 1 }; // Shared, FRESH_BIT set when it holds an unread value
+
+public:
+	T &get_slot(int p_index) { return slots[p_index]; }
+
+	void reset() {
+		back = 0;
+		front = 2;
+		middle.store(1, std::memory_order_relaxed);
+	}
+
+	// Writer side: fill get_write_slot(), then publish() it
+	T &get_write_slot() { return slots[back]; }
+	void publish() {
+		back = middle.exchange(back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	// Reader side: update() swaps in the newest value if there is one, get_read_slot() stays valid until the next update()
+	bool update() {
+		if (!(middle.load(std::memory_order_relaxed) & FRESH_BIT)) {
+			return false;
+		}
+		front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+	const T &get_read_slot() const { return slots[front]; }
+};
+
+#endif // TRIPLE_BUFFER_H
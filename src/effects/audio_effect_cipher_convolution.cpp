@@ -0,0 +1,515 @@
+/**************************************************************************/
+/*  audio_effect_cipher_convolution.cpp                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "audio_effect_cipher_convolution.h"
+#include <godot_cpp/classes/audio_server.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <cmath>
+#include <cstring>
+
+// Linear interpolation is enough here, IRs are normally authored at 44.1/48 kHz
+static std::vector<float> _resample_ir(const PackedFloat32Array &p_ir, float p_from_rate, float p_to_rate) {
+	const float *src = p_ir.ptr();
+	int src_length = p_ir.size();
+
+	if (p_from_rate <= 0.0f || p_from_rate == p_to_rate) {
+		return std::vector<float>(src, src + src_length);
+	}
+
+	double step = (double)p_from_rate / p_to_rate;
+	int length = MAX(1, (int)((src_length - 1) / step) + 1);
+	std::vector<float> result(length);
+
+	for (int i = 0; i < length; i++) {
+		double position = i * step;
+		int index = (int)position;
+		float frac = (float)(position - index);
+		float a = src[index];
+		float b = (index + 1 < src_length) ? src[index + 1] : 0.0f;
+		result[i] = a + (b - a) * frac;
+	}
+	return result;
+}
+
+// AudioEffectCipherConvolutionInstance Implementation
+
+// Old convolvers waiting to be freed on the main thread
+static const int RETIRE_CAPACITY = 8;
+
+AudioEffectCipherConvolutionInstance::AudioEffectCipherConvolutionInstance() {
+}
+
+AudioEffectCipherConvolutionInstance::~AudioEffectCipherConvolutionInstance() {
+	if (base.is_valid()) {
+		std::lock_guard<std::mutex> lock(base->instances_mutex);
+		std::vector<AudioEffectCipherConvolutionInstance *> &list = base->instances;
+		for (size_t i = 0; i < list.size(); i++) {
+			if (list[i] == this) {
+				list.erase(list.begin() + i);
+				break;
+			}
+		}
+	}
+
+	_watch_retired(false);
+	_free();
+}
+
+NonUniformConvolver *AudioEffectCipherConvolutionInstance::_build(const PackedFloat32Array &p_left, const PackedFloat32Array &p_right, float p_ir_rate, float p_mix_rate, int p_block_size) {
+	std::vector<float> left = _resample_ir(p_left, p_ir_rate, p_mix_rate);
+	std::vector<float> right = p_right.is_empty() ? left : _resample_ir(p_right, p_ir_rate, p_mix_rate);
+
+	NonUniformConvolver *convolver = new NonUniformConvolver;
+	const float *irs[2] = { left.data(), right.data() };
+	if (convolver->configure(irs, 2, (int)left.size(), p_block_size) != OK) {
+		delete convolver;
+		return nullptr;
+	}
+	return convolver;
+}
+
+void AudioEffectCipherConvolutionInstance::_setup(const PackedFloat32Array &p_left, const PackedFloat32Array &p_right, float p_ir_rate, int p_block_size) {
+	_free();
+
+	mix_rate = AudioServer::get_singleton()->get_mix_rate();
+
+	for (int c = 0; c < 2; c++) {
+		input_block[c] = new float[p_block_size]();
+		output_block[c] = new float[p_block_size]();
+		fade_block[c] = new float[p_block_size]();
+	}
+	block_size = p_block_size;
+	block_fill = 0;
+	retired.resize(RETIRE_CAPACITY);
+
+	// The first IR is built synchronously, this runs on the main thread
+	if (!p_left.is_empty()) {
+		active.store(_build(p_left, p_right, p_ir_rate, mix_rate, block_size));
+	}
+}
+
+void AudioEffectCipherConvolutionInstance::_free() {
+	if (task_id >= 0) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+		task_id = -1;
+	}
+
+	_collect_retired();
+	retire_pending.store(0, std::memory_order_relaxed);
+	delete active.exchange(nullptr);
+	delete incoming.exchange(nullptr);
+	delete fading;
+	fading = nullptr;
+	crossfading = false;
+
+	for (int c = 0; c < 2; c++) {
+		delete[] input_block[c];
+		delete[] output_block[c];
+		delete[] fade_block[c];
+		input_block[c] = nullptr;
+		output_block[c] = nullptr;
+		fade_block[c] = nullptr;
+	}
+	block_size = 0;
+	block_fill = 0;
+}
+
+void AudioEffectCipherConvolutionInstance::_submit(const PackedFloat32Array &p_left, const PackedFloat32Array &p_right, float p_ir_rate) {
+	_collect_retired();
+
+	std::lock_guard<std::mutex> lock(request_mutex);
+
+	// A request that has not started yet is simply replaced
+	request_left = p_left;
+	request_right = p_right;
+	request_rate = p_ir_rate;
+	request_pending = true;
+
+	if (task_running) {
+		return; // The running task picks the request up when it finishes the current one
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (task_id >= 0) {
+		pool->wait_for_task_completion(task_id); // Already done, this only releases it
+	}
+	task_running = true;
+	task_id = pool->add_native_task(&AudioEffectCipherConvolutionInstance::_prepare_task, this, false, "Prepare convolution IR");
+
+	_watch_retired(true);
+}
+
+void AudioEffectCipherConvolutionInstance::_prepare_task(void *p_userdata) {
+	AudioEffectCipherConvolutionInstance *instance = (AudioEffectCipherConvolutionInstance *)p_userdata;
+
+	while (true) {
+		PackedFloat32Array left;
+		PackedFloat32Array right;
+		float ir_rate;
+		{
+			std::lock_guard<std::mutex> lock(instance->request_mutex);
+			if (!instance->request_pending) {
+				instance->task_running = false;
+				return;
+			}
+			left = instance->request_left;
+			right = instance->request_right;
+			ir_rate = instance->request_rate;
+			instance->request_pending = false;
+		}
+
+		// An empty IR publishes nothing, the current IR keeps playing
+		NonUniformConvolver *convolver = left.is_empty() ? nullptr : _build(left, right, ir_rate, instance->mix_rate, instance->block_size);
+		if (convolver == nullptr) {
+			continue;
+		}
+
+		// Replaces an IR the audio thread has not picked up yet; that one was never seen there
+		delete instance->incoming.exchange(convolver, std::memory_order_acq_rel);
+	}
+}
+
+void AudioEffectCipherConvolutionInstance::_collect_retired() {
+	NonUniformConvolver *convolver;
+	while (retired.read(&convolver, 1) == 1) {
+		delete convolver;
+		retire_pending.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+void AudioEffectCipherConvolutionInstance::_watch_retired(bool p_enabled) {
+	// Main thread: poll once per frame until the swap is over, so the old IR is freed right after
+	// its crossfade instead of at the next swap. Without a SceneTree the next swap or _free() collects.
+	SceneTree *tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+	if (tree == nullptr) {
+		return;
+	}
+	Callable poll = callable_mp(this, &AudioEffectCipherConvolutionInstance::_poll_retired);
+	if (p_enabled != tree->is_connected("process_frame", poll)) {
+		if (p_enabled) {
+			tree->connect("process_frame", poll);
+		} else {
+			tree->disconnect("process_frame", poll);
+		}
+	}
+}
+
+void AudioEffectCipherConvolutionInstance::_poll_retired() {
+	_collect_retired();
+
+	// The audio thread counts a retirement before it takes the incoming convolver, so once nothing
+	// is being prepared or waiting, retire_pending covers every old convolver still to come
+	if (!is_swap_pending() && retire_pending.load(std::memory_order_acquire) == 0) {
+		_watch_retired(false);
+	}
+}
+
+void AudioEffectCipherConvolutionInstance::_process_block() {
+	// Start a crossfade once the previous one is finished and its convolver handed off
+	if (!crossfading && fading == nullptr && incoming.load(std::memory_order_relaxed) != nullptr) {
+		fading = active.load(std::memory_order_relaxed);
+		if (fading != nullptr) {
+			retire_pending.fetch_add(1, std::memory_order_relaxed);
+		}
+		active.store(incoming.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_release);
+		fade_length = MAX(1, (int)(crossfade_time * mix_rate));
+		fade_position = 0;
+		crossfading = true;
+	}
+
+	NonUniformConvolver *current = active.load(std::memory_order_relaxed);
+	if (current != nullptr) {
+		current->process(input_block, output_block);
+	} else {
+		memset(output_block[0], 0, block_size * sizeof(float));
+		memset(output_block[1], 0, block_size * sizeof(float));
+	}
+
+	if (crossfading) {
+		if (fading != nullptr) {
+			fading->process(input_block, fade_block);
+		} else {
+			memset(fade_block[0], 0, block_size * sizeof(float));
+			memset(fade_block[1], 0, block_size * sizeof(float));
+		}
+
+		// Equal-power fade (the tails are uncorrelated), gains interpolated linearly inside the block
+		float from = (float)fade_position / fade_length;
+		float to = MIN(1.0f, (float)(fade_position + block_size) / fade_length);
+		float in_start = sinf(from * (float)Math_PI * 0.5f);
+		float in_end = sinf(to * (float)Math_PI * 0.5f);
+		float out_start = cosf(from * (float)Math_PI * 0.5f);
+		float out_end = cosf(to * (float)Math_PI * 0.5f);
+		float step = 1.0f / block_size;
+
+		for (int c = 0; c < 2; c++) {
+			float *out = output_block[c];
+			const float *old = fade_block[c];
+			for (int i = 0; i < block_size; i++) {
+				float t = i * step;
+				float gain_in = in_start + (in_end - in_start) * t;
+				float gain_out = out_start + (out_end - out_start) * t;
+				out[i] = out[i] * gain_in + old[i] * gain_out;
+			}
+		}
+
+		fade_position += block_size;
+		crossfading = fade_position < fade_length;
+	}
+
+	// Hand the faded-out convolver to the main thread; retried next block if the ring is full.
+	// Its worker is told to exit now, the join happens with the delete.
+	if (!crossfading && fading != nullptr) {
+		fading->stop();
+		if (retired.write(&fading, 1) == 1) {
+			fading = nullptr;
+		}
+	}
+}
+
+void AudioEffectCipherConvolutionInstance::_process(const void *p_src_buffer, AudioFrame *p_dst_buffer, int32_t p_frame_count) {
+	const AudioFrame *src = (const AudioFrame *)p_src_buffer;
+
+	if (block_size == 0) {
+		if (src != p_dst_buffer) {
+			memcpy(p_dst_buffer, src, p_frame_count * sizeof(AudioFrame));
+		}
+		return;
+	}
+
+	// One consistent parameter snapshot per call; dry/wet ramp across it
+	AudioEffectCipherConvolution::Params params;
+	if (base->params.read(params)) {
+		dry = params.dry;
+		wet = params.wet;
+		crossfade_time = params.crossfade_time;
+	}
+
+	float dry_step;
+	float wet_step;
+	float dry_gain = dry_ramp.begin(dry, p_frame_count, dry_step);
+	float wet_gain = wet_ramp.begin(wet, p_frame_count, wet_step);
+
+	float *in_l = input_block[0];
+	float *in_r = input_block[1];
+	const float *out_l = output_block[0];
+	const float *out_r = output_block[1];
+
+	for (int32_t i = 0; i < p_frame_count; i++) {
+		// src and dst may be the same buffer, read before writing
+		float l = src[i].left;
+		float r = src[i].right;
+
+		in_l[block_fill] = l;
+		in_r[block_fill] = r;
+		p_dst_buffer[i].left = l * dry_gain + out_l[block_fill] * wet_gain;
+		p_dst_buffer[i].right = r * dry_gain + out_r[block_fill] * wet_gain;
+		dry_gain += dry_step;
+		wet_gain += wet_step;
+
+		if (++block_fill == block_size) {
+			_process_block();
+			block_fill = 0;
+		}
+	}
+}
+
+bool AudioEffectCipherConvolutionInstance::_process_silence() const {
+	return true; // Let the tail ring out after the input stops, and pick up swapped IRs
+}
+
+int AudioEffectCipherConvolutionInstance::get_partition_count() const {
+	NonUniformConvolver *current = active.load(std::memory_order_acquire);
+	return current ? current->get_partition_count() : 0;
+}
+
+int AudioEffectCipherConvolutionInstance::get_stage_count() const {
+	NonUniformConvolver *current = active.load(std::memory_order_acquire);
+	return current ? current->get_stage_count() : 0;
+}
+
+int AudioEffectCipherConvolutionInstance::get_underrun_count() const {
+	NonUniformConvolver *current = active.load(std::memory_order_acquire);
+	return current ? (int)current->get_underrun_count() : 0;
+}
+
+bool AudioEffectCipherConvolutionInstance::is_swap_pending() const {
+	std::lock_guard<std::mutex> lock(request_mutex);
+	return task_running || incoming.load(std::memory_order_acquire) != nullptr;
+}
+
+void AudioEffectCipherConvolutionInstance::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_partition_count"), &AudioEffectCipherConvolutionInstance::get_partition_count);
+	ClassDB::bind_method(D_METHOD("get_stage_count"), &AudioEffectCipherConvolutionInstance::get_stage_count);
+	ClassDB::bind_method(D_METHOD("get_underrun_count"), &AudioEffectCipherConvolutionInstance::get_underrun_count);
+	ClassDB::bind_method(D_METHOD("is_swap_pending"), &AudioEffectCipherConvolutionInstance::is_swap_pending);
+}
+
+// AudioEffectCipherConvolution Implementation
+
+AudioEffectCipherConvolution::AudioEffectCipherConvolution() {
+}
+
+AudioEffectCipherConvolution::~AudioEffectCipherConvolution() {
+}
+
+Error AudioEffectCipherConvolution::decode_wav(const Ref<AudioStreamWAV> &p_stream, PackedFloat32Array &r_left, PackedFloat32Array &r_right) {
+	ERR_FAIL_COND_V(p_stream.is_null(), ERR_INVALID_PARAMETER);
+
+	AudioStreamWAV::Format format = p_stream->get_format();
+	ERR_FAIL_COND_V_MSG(format != AudioStreamWAV::FORMAT_8_BITS && format != AudioStreamWAV::FORMAT_16_BITS, ERR_UNAVAILABLE,
+			"Only 8-bit and 16-bit PCM AudioStreamWAV impulse responses are supported.");
+
+	PackedByteArray data = p_stream->get_data();
+	const uint8_t *bytes = data.ptr();
+	int channels = p_stream->is_stereo() ? 2 : 1;
+	int sample_bytes = (format == AudioStreamWAV::FORMAT_16_BITS) ? 2 : 1;
+	int frames = data.size() / (channels * sample_bytes);
+	ERR_FAIL_COND_V(frames == 0, ERR_INVALID_DATA);
+
+	r_left.resize(frames);
+	r_right.resize(channels == 2 ? frames : 0);
+	float *out[2] = { r_left.ptrw(), channels == 2 ? r_right.ptrw() : nullptr };
+
+	for (int i = 0; i < frames; i++) {
+		for (int c = 0; c < channels; c++) {
+			int index = i * channels + c;
+			if (sample_bytes == 2) {
+				int16_t value = (int16_t)(bytes[index * 2] | (bytes[index * 2 + 1] << 8));
+				out[c][i] = value / 32768.0f;
+			} else {
+				out[c][i] = (int8_t)bytes[index] / 128.0f;
+			}
+		}
+	}
+	return OK;
+}
+
+void AudioEffectCipherConvolution::set_impulse_response_data(const PackedFloat32Array &p_left, const PackedFloat32Array &p_right, float p_sample_rate) {
+	ERR_FAIL_COND_MSG(!p_right.is_empty() && p_right.size() != p_left.size(), "Left and right impulse responses must have the same length.");
+	ir_left = p_left;
+	ir_right = p_right;
+	ir_sample_rate = MAX(p_sample_rate, 0.0f);
+	impulse_response.unref();
+
+	_submit_to_instances();
+}
+
+PackedFloat32Array AudioEffectCipherConvolution::get_impulse_response_left() const {
+	return ir_left;
+}
+
+PackedFloat32Array AudioEffectCipherConvolution::get_impulse_response_right() const {
+	return ir_right;
+}
+
+void AudioEffectCipherConvolution::set_impulse_response(const Ref<AudioStreamWAV> &p_stream) {
+	impulse_response = p_stream;
+	ir_left = PackedFloat32Array();
+	ir_right = PackedFloat32Array();
+	ir_sample_rate = 0.0f;
+
+	if (p_stream.is_valid() && decode_wav(p_stream, ir_left, ir_right) == OK) {
+		ir_sample_rate = p_stream->get_mix_rate();
+	}
+
+	_submit_to_instances();
+}
+
+void AudioEffectCipherConvolution::_submit_to_instances() {
+	std::lock_guard<std::mutex> lock(instances_mutex);
+	for (AudioEffectCipherConvolutionInstance *instance : instances) {
+		instance->_submit(ir_left, ir_right, ir_sample_rate);
+	}
+}
+
+Ref<AudioStreamWAV> AudioEffectCipherConvolution::get_impulse_response() const {
+	return impulse_response;
+}
+
+void AudioEffectCipherConvolution::set_block_size(int p_size) {
+	ERR_FAIL_COND_MSG(!UniformConvolver::is_valid_block_size(p_size), "Invalid block size, 2 * block_size must be a valid real FFT size.");
+	block_size = p_size;
+}
+
+int AudioEffectCipherConvolution::get_block_size() const {
+	return block_size;
+}
+
+void AudioEffectCipherConvolution::set_crossfade_time(float p_seconds) {
+	params.edit().crossfade_time = MAX(p_seconds, 0.0f);
+	params.publish();
+}
+
+float AudioEffectCipherConvolution::get_crossfade_time() const {
+	return params.get().crossfade_time;
+}
+
+void AudioEffectCipherConvolution::set_dry(float p_dry) {
+	params.edit().dry = p_dry;
+	params.publish();
+}
+
+float AudioEffectCipherConvolution::get_dry() const {
+	return params.get().dry;
+}
+
+void AudioEffectCipherConvolution::set_wet(float p_wet) {
+	params.edit().wet = p_wet;
+	params.publish();
+}
+
+float AudioEffectCipherConvolution::get_wet() const {
+	return params.get().wet;
+}
+
+Ref<AudioEffectInstance> AudioEffectCipherConvolution::_instantiate() {
+	Ref<AudioEffectCipherConvolutionInstance> instance;
+	instance.instantiate();
+	instance->base = Ref<AudioEffectCipherConvolution>(this);
+	instance->_setup(ir_left, ir_right, ir_sample_rate, block_size);
+
+	std::lock_guard<std::mutex> lock(instances_mutex);
+	instances.push_back(instance.ptr());
+	return instance;
+}
+
+void AudioEffectCipherConvolution::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_impulse_response_data", "left", "right", "sample_rate"), &AudioEffectCipherConvolution::set_impulse_response_data, DEFVAL(PackedFloat32Array()), DEFVAL(0.0f));
+	ClassDB::bind_method(D_METHOD("get_impulse_response_left"), &AudioEffectCipherConvolution::get_impulse_response_left);
+	ClassDB::bind_method(D_METHOD("get_impulse_response_right"), &AudioEffectCipherConvolution::get_impulse_response_right);
+
+	ClassDB::bind_method(D_METHOD("set_impulse_response", "stream"), &AudioEffectCipherConvolution::set_impulse_response);
+	ClassDB::bind_method(D_METHOD("get_impulse_response"), &AudioEffectCipherConvolution::get_impulse_response);
+
+	ClassDB::bind_method(D_METHOD("set_block_size", "size"), &AudioEffectCipherConvolution::set_block_size);
+	ClassDB::bind_method(D_METHOD("get_block_size"), &AudioEffectCipherConvolution::get_block_size);
+
+	ClassDB::bind_method(D_METHOD("set_crossfade_time", "seconds"), &AudioEffectCipherConvolution::set_crossfade_time);
+	ClassDB::bind_method(D_METHOD("get_crossfade_time"), &AudioEffectCipherConvolution::get_crossfade_time);
+
+	ClassDB::bind_method(D_METHOD("set_dry", "amount"), &AudioEffectCipherConvolution::set_dry);
+	ClassDB::bind_method(D_METHOD("get_dry"), &AudioEffectCipherConvolution::get_dry);
+
+	ClassDB::bind_method(D_METHOD("set_wet", "amount"), &AudioEffectCipherConvolution::set_wet);
+	ClassDB::bind_method(D_METHOD("get_wet"), &AudioEffectCipherConvolution::get_wet);
+
+	ClassDB::bind_method(D_METHOD("get_latency"), &AudioEffectCipherConvolution::get_latency);
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "impulse_response", PROPERTY_HINT_RESOURCE_TYPE, "AudioStreamWAV"),
+			"set_impulse_response", "get_impulse_response");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "block_size", PROPERTY_HINT_ENUM, "64:64,128:128,256:256,512:512,1024:1024,2048:2048"),
+			"set_block_size", "get_block_size");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "crossfade_time", PROPERTY_HINT_RANGE, "0,5,0.01,suffix:s"), "set_crossfade_time", "get_crossfade_time");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "dry", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_dry", "get_dry");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "wet", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_wet", "get_wet");
+}
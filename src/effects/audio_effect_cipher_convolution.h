@@ -0,0 +1,173 @@
+/**************************************************************************/
+/*  audio_effect_cipher_convolution.h                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef AUDIO_EFFECT_CIPHER_CONVOLUTION_H
+#define AUDIO_EFFECT_CIPHER_CONVOLUTION_H
+
+#include <godot_cpp/classes/audio_effect.hpp>
+#include <godot_cpp/classes/audio_effect_instance.hpp>
+#include <godot_cpp/classes/audio_frame.hpp>
+#include <godot_cpp/classes/audio_stream_wav.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+#include "non_uniform_convolver.h"
+#include "param_snapshot.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace godot;
+
+class AudioEffectCipherConvolution;
+
+// Stereo convolution through a NonUniformConvolver: the IR head runs here on the audio thread,
+// the tail on the convolver's worker. Input is collected into block_size chunks, so the wet signal
+// is delayed by exactly one block.
+// New IRs are prepared on the WorkerThreadPool and published through an atomic pointer; the audio
+// thread crossfades to them, stops the old convolver's worker and hands it back through a ring to
+// be freed on the main thread at the next frame. _process never locks or allocates.
+class AudioEffectCipherConvolutionInstance : public AudioEffectInstance {
+	GDCLASS(AudioEffectCipherConvolutionInstance, AudioEffectInstance)
+
+	friend class AudioEffectCipherConvolution;
+
+private:
+	Ref<AudioEffectCipherConvolution> base;
+
+	float *input_block[2] = {};
+	float *output_block[2] = {};
+	float *fade_block[2] = {};
+	int block_size = 0;
+	int block_fill = 0;
+	float mix_rate = 44100.0f;
+
+	// Audio thread: last parameter snapshot and dry/wet smoothing
+	float dry = 1.0f;
+	float wet = 0.0f;
+	float crossfade_time = 0.0f;
+	ParamRamp dry_ramp;
+	ParamRamp wet_ramp;
+
+	// Written by the audio thread only; atomic so the main thread can query stats
+	std::atomic<NonUniformConvolver *> active{ nullptr };
+
+	// Audio thread only
+	NonUniformConvolver *fading = nullptr;
+	int fade_length = 0;
+	int fade_position = 0;
+	bool crossfading = false;
+
+	// Preparation task -> audio thread -> main thread
+	std::atomic<NonUniformConvolver *> incoming{ nullptr };
+	SPSCRing<NonUniformConvolver *> retired;
+	std::atomic<int> retire_pending{ 0 }; // Convolvers replaced by the audio thread and not yet freed
+
+	// Main thread -> preparation task
+	mutable std::mutex request_mutex;
+	PackedFloat32Array request_left;
+	PackedFloat32Array request_right;
+	float request_rate = 0.0f;
+	bool request_pending = false;
+	bool task_running = false;
+	int64_t task_id = -1;
+
+	static NonUniformConvolver *_build(const PackedFloat32Array &p_left, const PackedFloat32Array &p_right, float p_ir_rate, float p_mix_rate, int p_block_size);
+	static void _prepare_task(void *p_userdata);
+
+	void _setup(const PackedFloat32Array &p_left, const PackedFloat32Array &p_right, float p_ir_rate, int p_block_size);
+	void _submit(const PackedFloat32Array &p_left, const PackedFloat32Array &p_right, float p_ir_rate);
+	void _collect_retired();
+	void _watch_retired(bool p_enabled);
+	void _poll_retired();
+	void _process_block();
+	void _free();
+
+protected:
+	static void _bind_methods();
+
+public:
+	AudioEffectCipherConvolutionInstance();
+	~AudioEffectCipherConvolutionInstance();
+
+	virtual void _process(const void *p_src_buffer, AudioFrame *p_dst_buffer, int32_t p_frame_count) override;
+	virtual bool _process_silence() const override;
+
+	int get_partition_count() const;
+	int get_stage_count() const;
+	int get_underrun_count() const;
+	bool is_swap_pending() const;
+};
+
+class AudioEffectCipherConvolution : public AudioEffect {
+	GDCLASS(AudioEffectCipherConvolution, AudioEffect)
+
+	friend class AudioEffectCipherConvolutionInstance;
+
+public:
+	// Everything the instances read on the audio thread
+	struct Params {
+		float crossfade_time = 0.25f;
+		float dry = 1.0f;
+		float wet = 0.5f;
+	};
+
+private:
+	Ref<AudioStreamWAV> impulse_response;
+	PackedFloat32Array ir_left;
+	PackedFloat32Array ir_right; // Empty for a mono IR
+	float ir_sample_rate = 0.0f; // 0 = already at the mix rate
+
+	int block_size = 256;
+	ParamSnapshot<Params> params;
+
+	// Live instances, so a new IR is swapped into running buses
+	std::mutex instances_mutex;
+	std::vector<AudioEffectCipherConvolutionInstance *> instances;
+
+	void _submit_to_instances();
+
+protected:
+	static void _bind_methods();
+
+public:
+	AudioEffectCipherConvolution();
+	~AudioEffectCipherConvolution();
+
+	// Raw IR data, resampled to the mix rate when p_sample_rate differs.
+	// Running instances crossfade to the new IR once it has been prepared off the audio thread.
+	void set_impulse_response_data(const PackedFloat32Array &p_left, const PackedFloat32Array &p_right = PackedFloat32Array(), float p_sample_rate = 0.0f);
+	PackedFloat32Array get_impulse_response_left() const;
+	PackedFloat32Array get_impulse_response_right() const;
+
+	// 8/16-bit PCM only, compressed formats are rejected
+	void set_impulse_response(const Ref<AudioStreamWAV> &p_stream);
+	Ref<AudioStreamWAV> get_impulse_response() const;
+
+	void set_block_size(int p_size);
+	int get_block_size() const;
+
+	void set_crossfade_time(float p_seconds);
+	float get_crossfade_time() const;
+
+	void set_dry(float p_dry);
+	float get_dry() const;
+
+	void set_wet(float p_wet);
+	float get_wet() const;
+
+	// Latency of the wet signal in frames
+	int get_latency() const { return block_size; }
+
+	static Error decode_wav(const Ref<AudioStreamWAV> &p_stream, PackedFloat32Array &r_left, PackedFloat32Array &r_right);
+
+	virtual Ref<AudioEffectInstance> _instantiate() override;
+};
+
+#endif // AUDIO_EFFECT_CIPHER_CONVOLUTION_H
@@ -0,0 +1,256 @@
+/**************************************************************************/
+/*  audio_effect_cipher_spectrum.cpp                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "audio_effect_cipher_spectrum.h"
+#include "spectrum_kernels.h"
+#include <godot_cpp/classes/audio_server.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+// Samples moved from the ring to the STFT per iteration on the analysis thread
+static const int DRAIN_CHUNK = 1024;
+
+// AudioEffectCipherSpectrumInstance Implementation
+
+AudioEffectCipherSpectrumInstance::AudioEffectCipherSpectrumInstance() {
+}
+
+AudioEffectCipherSpectrumInstance::~AudioEffectCipherSpectrumInstance() {
+	_shutdown();
+}
+
+void AudioEffectCipherSpectrumInstance::_setup(int p_fft_size, int p_hop_size, STFTProcessor::WindowType p_window) {
+	_shutdown();
+
+	mix_rate = AudioServer::get_singleton()->get_mix_rate();
+
+	stft.instantiate();
+	stft->set_max_queued_frames(4);
+	ERR_FAIL_COND(stft->setup(p_fft_size, p_hop_size, p_window) != OK);
+
+	spectrum.instantiate();
+	spectrum->resize(p_fft_size + 2);
+
+	// A full-scale sine reads 1.0 at its bin
+	magnitude_scale = 2.0f / stft->get_window_sum();
+
+	spectrum_size = stft->get_spectrum_size();
+	for (int i = 0; i < 3; i++) {
+		magnitude_slots[i] = new float[spectrum_size]();
+		magnitudes.get_slot(i) = magnitude_slots[i];
+	}
+	magnitudes.reset();
+
+	drain_buffer = new float[DRAIN_CHUNK];
+
+	// Room for a few hops of analysis stall (or a large mix chunk) before samples are dropped
+	sample_ring.resize(MAX(p_fft_size, 8192) * 2);
+
+	running.store(true);
+	worker = std::thread(&AudioEffectCipherSpectrumInstance::_worker_loop, this);
+}
+
+void AudioEffectCipherSpectrumInstance::_shutdown() {
+	if (worker.joinable()) {
+		running.store(false);
+		wake_condition.notify_one();
+		worker.join();
+	}
+
+	for (int i = 0; i < 3; i++) {
+		delete[] magnitude_slots[i];
+		magnitude_slots[i] = nullptr;
+	}
+	delete[] drain_buffer;
+	drain_buffer = nullptr;
+	spectrum_size = 0;
+}
+
+void AudioEffectCipherSpectrumInstance::_worker_loop() {
+	while (running.load(std::memory_order_acquire)) {
+		{
+			// The audio thread signals without taking the lock, so a wakeup can be missed;
+			// the short timeout bounds the extra latency in that rare case.
+			std::unique_lock<std::mutex> lock(wake_mutex);
+			wake_condition.wait_for(lock, std::chrono::milliseconds(2), [this]() {
+				return pending.load(std::memory_order_acquire) || !running.load(std::memory_order_acquire);
+			});
+		}
+		pending.store(false, std::memory_order_release);
+
+		_analyze_pending();
+	}
+}
+
+void AudioEffectCipherSpectrumInstance::_analyze_pending() {
+	int frames = 0;
+	uint32_t count;
+	while ((count = sample_ring.read(drain_buffer, DRAIN_CHUNK)) > 0) {
+		frames += stft->push_samples_ptr(drain_buffer, count);
+	}
+
+	if (frames == 0) {
+		return;
+	}
+
+	// Only the newest spectrum is shown, older ones are skipped
+	while (stft->pop_spectrum(spectrum)) {
+	}
+
+	float *output = magnitudes.get_write_slot();
+	SpectrumKernels::magnitude(spectrum->get_buffer_ptr(), output, spectrum_size);
+	SpectrumKernels::scale(output, spectrum_size, magnitude_scale);
+
+	magnitudes.publish();
+	frame_count.fetch_add(1, std::memory_order_release);
+}
+
+void AudioEffectCipherSpectrumInstance::_process(const void *p_src_buffer, AudioFrame *p_dst_buffer, int32_t p_frame_count) {
+	const AudioFrame *src = (const AudioFrame *)p_src_buffer;
+
+	// Pass-through
+	if (src != p_dst_buffer) {
+		memcpy(p_dst_buffer, src, p_frame_count * sizeof(AudioFrame));
+	}
+
+	if (spectrum_size == 0) {
+		return;
+	}
+
+	// Downmix to mono in stack-sized chunks and hand them to the analysis thread
+	float mono[256];
+	for (int32_t offset = 0; offset < p_frame_count; offset += 256) {
+		int32_t chunk = MIN(256, p_frame_count - offset);
+		for (int32_t i = 0; i < chunk; i++) {
+			mono[i] = (src[offset + i].left + src[offset + i].right) * 0.5f;
+		}
+		sample_ring.write(mono, chunk);
+	}
+
+	pending.store(true, std::memory_order_release);
+	wake_condition.notify_one();
+}
+
+bool AudioEffectCipherSpectrumInstance::_process_silence() const {
+	return true; // Keep analysing so the spectrum falls to zero when the bus goes quiet
+}
+
+PackedFloat32Array AudioEffectCipherSpectrumInstance::get_magnitude_spectrum() {
+	PackedFloat32Array result;
+	if (spectrum_size == 0) {
+		return result;
+	}
+
+	magnitudes.update();
+	result.resize(spectrum_size);
+	memcpy(result.ptrw(), magnitudes.get_read_slot(), spectrum_size * sizeof(float));
+	return result;
+}
+
+bool AudioEffectCipherSpectrumInstance::get_magnitude_spectrum_buffer(const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND_V(p_output.is_null(), false);
+	if (spectrum_size == 0) {
+		return false;
+	}
+
+	bool fresh = magnitudes.update();
+	p_output->resize(spectrum_size);
+	memcpy(p_output->get_buffer_ptr(), magnitudes.get_read_slot(), spectrum_size * sizeof(float));
+	return fresh;
+}
+
+float AudioEffectCipherSpectrumInstance::get_magnitude_for_frequency_range(float p_from_hz, float p_to_hz) {
+	if (spectrum_size == 0) {
+		return 0.0f;
+	}
+
+	magnitudes.update();
+	const float *data = magnitudes.get_read_slot();
+
+	// Bin k covers k * mix_rate / fft_size
+	float bins_per_hz = (spectrum_size - 1) * 2 / mix_rate;
+	int from = CLAMP((int)floorf(p_from_hz * bins_per_hz), 0, spectrum_size - 1);
+	int to = CLAMP((int)ceilf(p_to_hz * bins_per_hz), from, spectrum_size - 1);
+
+	float peak = 0.0f;
+	for (int i = from; i <= to; i++) {
+		peak = MAX(peak, data[i]);
+	}
+	return peak;
+}
+
+void AudioEffectCipherSpectrumInstance::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_spectrum_size"), &AudioEffectCipherSpectrumInstance::get_spectrum_size);
+	ClassDB::bind_method(D_METHOD("get_frame_count"), &AudioEffectCipherSpectrumInstance::get_frame_count);
+	ClassDB::bind_method(D_METHOD("get_magnitude_spectrum"), &AudioEffectCipherSpectrumInstance::get_magnitude_spectrum);
+	ClassDB::bind_method(D_METHOD("get_magnitude_spectrum_buffer", "output"), &AudioEffectCipherSpectrumInstance::get_magnitude_spectrum_buffer);
+	ClassDB::bind_method(D_METHOD("get_magnitude_for_frequency_range", "from_hz", "to_hz"), &AudioEffectCipherSpectrumInstance::get_magnitude_for_frequency_range);
+}
+
+// AudioEffectCipherSpectrum Implementation
+
+AudioEffectCipherSpectrum::AudioEffectCipherSpectrum() {
+}
+
+AudioEffectCipherSpectrum::~AudioEffectCipherSpectrum() {
+}
+
+void AudioEffectCipherSpectrum::set_fft_size(int p_size) {
+	ERR_FAIL_COND_MSG(!FFTProcessor::is_valid_fft_size(p_size), "Invalid FFT size, see FFTProcessor.is_valid_fft_size().");
+	fft_size = p_size;
+	hop_size = MIN(hop_size, fft_size);
+}
+
+int AudioEffectCipherSpectrum::get_fft_size() const {
+	return fft_size;
+}
+
+void AudioEffectCipherSpectrum::set_hop_size(int p_size) {
+	hop_size = CLAMP(p_size, 1, fft_size);
+}
+
+int AudioEffectCipherSpectrum::get_hop_size() const {
+	return hop_size;
+}
+
+void AudioEffectCipherSpectrum::set_window_type(STFTProcessor::WindowType p_window) {
+	window_type = p_window;
+}
+
+STFTProcessor::WindowType AudioEffectCipherSpectrum::get_window_type() const {
+	return window_type;
+}
+
+Ref<AudioEffectInstance> AudioEffectCipherSpectrum::_instantiate() {
+	Ref<AudioEffectCipherSpectrumInstance> instance;
+	instance.instantiate();
+	instance->base = Ref<AudioEffectCipherSpectrum>(this);
+	instance->_setup(fft_size, hop_size, window_type);
+	return instance;
+}
+
+void AudioEffectCipherSpectrum::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_fft_size", "size"), &AudioEffectCipherSpectrum::set_fft_size);
+	ClassDB::bind_method(D_METHOD("get_fft_size"), &AudioEffectCipherSpectrum::get_fft_size);
+
+	ClassDB::bind_method(D_METHOD("set_hop_size", "size"), &AudioEffectCipherSpectrum::set_hop_size);
+	ClassDB::bind_method(D_METHOD("get_hop_size"), &AudioEffectCipherSpectrum::get_hop_size);
+
+	ClassDB::bind_method(D_METHOD("set_window_type", "window"), &AudioEffectCipherSpectrum::set_window_type);
+	ClassDB::bind_method(D_METHOD("get_window_type"), &AudioEffectCipherSpectrum::get_window_type);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "fft_size", PROPERTY_HINT_ENUM, "256:256,512:512,1024:1024,2048:2048,4096:4096,8192:8192"),
+			"set_fft_size", "get_fft_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "hop_size", PROPERTY_HINT_RANGE, "1,8192,1"),
+			"set_hop_size", "get_hop_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "window_type", PROPERTY_HINT_ENUM, "Rectangular,Hann,Hamming,Blackman"),
+			"set_window_type", "get_window_type");
+}
@@ -0,0 +1,116 @@
+/**************************************************************************/
+/*  audio_effect_cipher_spectrum.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef AUDIO_EFFECT_CIPHER_SPECTRUM_H
+#define AUDIO_EFFECT_CIPHER_SPECTRUM_H
+
+#include <godot_cpp/classes/audio_effect.hpp>
+#include <godot_cpp/classes/audio_effect_instance.hpp>
+#include <godot_cpp/classes/audio_frame.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+#include "fft_buffer.h"
+#include "spsc_ring.h"
+#include "stft_processor.h"
+#include "triple_buffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace godot;
+
+class AudioEffectCipherSpectrum;
+
+// Audio thread -> SPSC ring -> analysis thread (STFT) -> triple buffer -> main thread.
+// Only _process runs on the audio thread and it never locks or allocates.
+class AudioEffectCipherSpectrumInstance : public AudioEffectInstance {
+	GDCLASS(AudioEffectCipherSpectrumInstance, AudioEffectInstance)
+
+	friend class AudioEffectCipherSpectrum;
+
+private:
+	Ref<AudioEffectCipherSpectrum> base;
+
+	// Audio thread -> analysis thread
+	SPSCRing<float> sample_ring;
+
+	// Analysis thread only
+	Ref<STFTProcessor> stft;
+	Ref<FFTBuffer> spectrum;
+	float *drain_buffer = nullptr;
+	float magnitude_scale = 1.0f;
+
+	// Analysis thread -> main thread
+	TripleBuffer<float *> magnitudes;
+	float *magnitude_slots[3] = {};
+	int spectrum_size = 0;
+	std::atomic<uint64_t> frame_count{ 0 };
+
+	std::thread worker;
+	std::mutex wake_mutex;
+	std::condition_variable wake_condition;
+	std::atomic<bool> running{ false };
+	std::atomic<bool> pending{ false };
+
+	float mix_rate = 44100.0f;
+
+	void _setup(int p_fft_size, int p_hop_size, STFTProcessor::WindowType p_window);
+	void _shutdown();
+	void _worker_loop();
+	void _analyze_pending();
+
+protected:
+	static void _bind_methods();
+
+public:
+	AudioEffectCipherSpectrumInstance();
+	~AudioEffectCipherSpectrumInstance();
+
+	virtual void _process(const void *p_src_buffer, AudioFrame *p_dst_buffer, int32_t p_frame_count) override;
+	virtual bool _process_silence() const override;
+
+	// Main thread access to the latest published spectrum (lock-free)
+	int get_spectrum_size() const { return spectrum_size; }
+	uint64_t get_frame_count() const { return frame_count.load(std::memory_order_acquire); }
+	PackedFloat32Array get_magnitude_spectrum();
+	bool get_magnitude_spectrum_buffer(const Ref<FFTBuffer> &p_output);
+	float get_magnitude_for_frequency_range(float p_from_hz, float p_to_hz);
+};
+
+class AudioEffectCipherSpectrum : public AudioEffect {
+	GDCLASS(AudioEffectCipherSpectrum, AudioEffect)
+
+	friend class AudioEffectCipherSpectrumInstance;
+
+private:
+	int fft_size = 2048;
+	int hop_size = 256;
+	STFTProcessor::WindowType window_type = STFTProcessor::WINDOW_HANN;
+
+protected:
+	static void _bind_methods();
+
+public:
+	AudioEffectCipherSpectrum();
+	~AudioEffectCipherSpectrum();
+
+	void set_fft_size(int p_size);
+	int get_fft_size() const;
+
+	void set_hop_size(int p_size);
+	int get_hop_size() const;
+
+	void set_window_type(STFTProcessor::WindowType p_window);
+	STFTProcessor::WindowType get_window_type() const;
+
+	virtual Ref<AudioEffectInstance> _instantiate() override;
+};
+
+#endif // AUDIO_EFFECT_CIPHER_SPECTRUM_H
@@ -0,0 +1,303 @@
+/**************************************************************************/
+/*  non_uniform_convolver.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "non_uniform_convolver.h"
+#include <chrono>
+#include <cstring>
+
+NonUniformConvolver::NonUniformConvolver() {
+}
+
+NonUniformConvolver::~NonUniformConvolver() {
+	_free();
+}
+
+void NonUniformConvolver::stop() {
+	running.store(false, std::memory_order_release);
+	wake_condition.notify_one();
+}
+
+void NonUniformConvolver::_free() {
+	if (worker.joinable()) {
+		stop();
+		worker.join();
+	}
+
+	for (int s = 0; s < stage_count; s++) {
+		for (int c = 0; c < MAX_CHANNELS; c++) {
+			delete[] stages[s].accumulator[c];
+			delete[] stages[s].block_output[c];
+		}
+	}
+	delete[] stages;
+	stages = nullptr;
+	stage_count = 0;
+
+	for (int c = 0; c < MAX_CHANNELS; c++) {
+		delete[] chunk[c];
+		chunk[c] = nullptr;
+	}
+	delete[] mix_buffer;
+	mix_buffer = nullptr;
+
+	channel_count = 0;
+	head_block = 0;
+	underrun_count.store(0);
+	sync_state.store(SYNC_RUNNING);
+}
+
+Error NonUniformConvolver::configure(const float *const *p_irs, int p_channel_count, int p_ir_length, int p_head_block) {
+	_free();
+
+	ERR_FAIL_COND_V(p_channel_count < 1 || p_channel_count > MAX_CHANNELS, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_ir_length <= 0, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!UniformConvolver::is_valid_block_size(p_head_block), ERR_INVALID_PARAMETER);
+
+	// Plan: the head covers up to twice the first tail block, each stage up to twice the next one.
+	// Growth stops at MAX_TAIL_BLOCK and the last stage takes the rest of the IR.
+	int stage_blocks[32];
+	int stage_offsets[32];
+	int stage_ends[32];
+	int planned = 0;
+
+	int block = p_head_block;
+	int head_end = p_ir_length;
+	if (block * TAIL_GROWTH <= MAX_TAIL_BLOCK) {
+		head_end = MIN(p_ir_length, 2 * block * TAIL_GROWTH);
+	}
+
+	int offset = head_end;
+	while (offset < p_ir_length && planned < 32) {
+		block *= TAIL_GROWTH;
+		bool last = block * TAIL_GROWTH > MAX_TAIL_BLOCK;
+		int end = last ? p_ir_length : MIN(p_ir_length, 2 * block * TAIL_GROWTH);
+
+		stage_blocks[planned] = block;
+		stage_offsets[planned] = offset;
+		stage_ends[planned] = end;
+		planned++;
+		offset = end;
+	}
+
+	for (int c = 0; c < p_channel_count; c++) {
+		if (head[c].configure(p_irs[c], head_end, p_head_block) != OK) {
+			ERR_FAIL_V(ERR_CANT_CREATE);
+		}
+	}
+
+	stages = new Stage[planned];
+	stage_count = planned;
+	channel_count = p_channel_count;
+	head_block = p_head_block;
+
+	uint32_t input_capacity = p_head_block * 4;
+	for (int s = 0; s < stage_count; s++) {
+		Stage &stage = stages[s];
+		stage.block_size = stage_blocks[s];
+		stage.offset = stage_offsets[s];
+		input_capacity = MAX(input_capacity, (uint32_t)stage.block_size * 4);
+
+		for (int c = 0; c < channel_count; c++) {
+			if (stage.convolvers[c].configure(p_irs[c] + stage.offset, stage_ends[s] - stage.offset, stage.block_size) != OK) {
+				_free();
+				ERR_FAIL_V(ERR_CANT_CREATE);
+			}
+			stage.accumulator[c] = new float[stage.block_size]();
+			stage.block_output[c] = new float[stage.block_size]();
+			stage.output[c].resize(stage.offset + stage.block_size * 2);
+		}
+	}
+
+	mix_buffer = new float[p_head_block]();
+	for (int c = 0; c < channel_count; c++) {
+		chunk[c] = new float[p_head_block]();
+		input[c].resize(input_capacity);
+	}
+	_reset_stages();
+
+	if (stage_count > 0) {
+		running.store(true);
+		worker = std::thread(&NonUniformConvolver::_worker_loop, this);
+	}
+
+	return OK;
+}
+
+void NonUniformConvolver::_reset_stages() {
+	// Only while the audio thread is not touching the rings: during configure() or SYNC_PAUSED
+	for (int c = 0; c < channel_count; c++) {
+		input[c].reset();
+	}
+
+	for (int s = 0; s < stage_count; s++) {
+		Stage &stage = stages[s];
+		stage.fill = 0;
+
+		for (int c = 0; c < channel_count; c++) {
+			stage.convolvers[c].reset();
+			stage.owed[c] = 0;
+
+			// Prefilled with the stage's delay, so ring position == output sample index
+			memset(stage.block_output[c], 0, stage.block_size * sizeof(float));
+			stage.output[c].reset();
+			for (int written = 0; written < stage.offset; written += stage.block_size) {
+				stage.output[c].write(stage.block_output[c], MIN(stage.block_size, stage.offset - written));
+			}
+		}
+	}
+}
+
+int NonUniformConvolver::get_stage_block_size(int p_stage) const {
+	ERR_FAIL_INDEX_V(p_stage, stage_count, 0);
+	return stages[p_stage].block_size;
+}
+
+int NonUniformConvolver::get_partition_count() const {
+	int count = head[0].get_partition_count();
+	for (int s = 0; s < stage_count; s++) {
+		count += stages[s].convolvers[0].get_partition_count();
+	}
+	return count;
+}
+
+void NonUniformConvolver::_worker_loop() {
+	while (running.load(std::memory_order_acquire)) {
+		{
+			// Same wakeup scheme as the spectrum analyzer: the audio thread signals without the lock
+			std::unique_lock<std::mutex> lock(wake_mutex);
+			wake_condition.wait_for(lock, std::chrono::milliseconds(2), [this]() {
+				return pending.load(std::memory_order_acquire) || !running.load(std::memory_order_acquire);
+			});
+		}
+		pending.store(false, std::memory_order_release);
+
+		int state = sync_state.load(std::memory_order_acquire);
+		if (state == SYNC_PAUSED) {
+			_reset_stages();
+			sync_state.store(SYNC_RUNNING, std::memory_order_release);
+		} else if (state == SYNC_RUNNING) {
+			_process_tails();
+		}
+	}
+}
+
+void NonUniformConvolver::_process_tails() {
+	while (true) {
+		// The audio thread writes a block to every channel or to none, but may be between two
+		// channels right now, so only the smallest fill level is complete
+		uint32_t available = input[0].available_read();
+		for (int c = 1; c < channel_count; c++) {
+			available = MIN(available, input[c].available_read());
+		}
+		if (available < (uint32_t)head_block) {
+			break;
+		}
+
+		for (int c = 0; c < channel_count; c++) {
+			input[c].read(chunk[c], head_block);
+		}
+
+		// Smallest stages first, they have the tightest deadline
+		for (int s = 0; s < stage_count; s++) {
+			Stage &stage = stages[s];
+			for (int c = 0; c < channel_count; c++) {
+				memcpy(stage.accumulator[c] + stage.fill, chunk[c], head_block * sizeof(float));
+			}
+			stage.fill += head_block;
+
+			if (stage.fill < stage.block_size) {
+				continue;
+			}
+			stage.fill = 0;
+
+			bool overflow = false;
+			for (int c = 0; c < channel_count; c++) {
+				stage.convolvers[c].process(stage.accumulator[c], stage.block_output[c]);
+				overflow |= stage.output[c].write(stage.block_output[c], stage.block_size) < (uint32_t)stage.block_size;
+			}
+
+			// Catching up after a long stall can outrun the audio thread's reads. The dropped samples
+			// would misalign the stage for good, so have everything reset instead
+			if (overflow) {
+				int expected = SYNC_RUNNING;
+				sync_state.compare_exchange_strong(expected, SYNC_REQUESTED, std::memory_order_acq_rel);
+				return;
+			}
+		}
+	}
+}
+
+void NonUniformConvolver::_mix_stage(Stage &p_stage, int p_channel, float *p_output) {
+	SPSCRing<float> &ring = p_stage.output[p_channel];
+	uint32_t &owed = p_stage.owed[p_channel];
+
+	// Drop samples that arrived too late, so the stage stays aligned with the head
+	if (owed > 0) {
+		owed -= ring.skip(owed);
+	}
+
+	uint32_t count = (owed > 0) ? 0 : ring.read(mix_buffer, head_block);
+	if (count < (uint32_t)head_block) {
+		owed += head_block - count;
+		if (p_channel == 0) {
+			underrun_count.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		p_output[i] += mix_buffer[i];
+	}
+}
+
+void NonUniformConvolver::process(const float *const *p_input, float *const *p_output) {
+	bool tail_running = false;
+	if (stage_count > 0) {
+		int state = sync_state.load(std::memory_order_acquire);
+
+		// A full input ring means the worker is several stage blocks behind. Writing only some
+		// channels, or dropping a block for all of them, would misalign the tail; resync instead
+		if (state == SYNC_RUNNING) {
+			for (int c = 0; c < channel_count; c++) {
+				if (input[c].available_write() < (uint32_t)head_block) {
+					state = SYNC_REQUESTED;
+					break;
+				}
+			}
+		}
+
+		// Let go of the rings; the worker resets them and switches back to SYNC_RUNNING
+		if (state == SYNC_REQUESTED) {
+			state = SYNC_PAUSED;
+			sync_state.store(SYNC_PAUSED, std::memory_order_release);
+		}
+
+		tail_running = state == SYNC_RUNNING;
+		if (tail_running) {
+			for (int c = 0; c < channel_count; c++) {
+				input[c].write(p_input[c], head_block);
+			}
+		} else {
+			underrun_count.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	for (int c = 0; c < channel_count; c++) {
+		head[c].process(p_input[c], p_output[c]);
+		if (!tail_running) {
+			continue;
+		}
+		for (int s = 0; s < stage_count; s++) {
+			_mix_stage(stages[s], c, p_output[c]);
+		}
+	}
+
+	if (stage_count > 0) {
+		pending.store(true, std::memory_order_release);
+		wake_condition.notify_one();
+	}
+}
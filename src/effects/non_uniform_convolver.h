@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*  non_uniform_convolver.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef NON_UNIFORM_CONVOLVER_H
+#define NON_UNIFORM_CONVOLVER_H
+
+#include "spsc_ring.h"
+#include "uniform_convolver.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Non-uniformly partitioned convolution of up to two channels.
+// The head of the IR is convolved on the audio thread with small blocks. The tail is split into
+// stages whose block size grows by TAIL_GROWTH; a worker thread runs them from an SPSC input ring
+// and hands the results back through one SPSC output ring per stage and channel.
+// Each stage starts at least two of its blocks into the IR, so the worker has a full block
+// period of slack before its output is due. If any ring overflows, the tail is muted until the
+// worker has reset every ring and stage together.
+class NonUniformConvolver {
+public:
+	static const int MAX_CHANNELS = 2;
+	static const int TAIL_GROWTH = 4;
+	static const int MAX_TAIL_BLOCK = 16384;
+
+private:
+	struct Stage {
+		int block_size = 0;
+		int offset = 0; // IR offset, also the output delay of this stage
+		UniformConvolver convolvers[MAX_CHANNELS];
+
+		// Worker thread only
+		float *accumulator[MAX_CHANNELS] = {};
+		float *block_output[MAX_CHANNELS] = {};
+		int fill = 0;
+
+		// Worker thread -> audio thread
+		SPSCRing<float> output[MAX_CHANNELS];
+
+		// Audio thread only (the worker resets it while paused); samples owed after an underrun,
+		// dropped once the worker catches up
+		uint32_t owed[MAX_CHANNELS] = {};
+	};
+
+	enum SyncState {
+		SYNC_RUNNING,
+		SYNC_REQUESTED, // A worker output ring overflowed; the audio thread pauses at its next block
+		SYNC_PAUSED, // The audio thread no longer touches the rings; the worker resets them
+	};
+
+	int channel_count = 0;
+	int head_block = 0;
+
+	UniformConvolver head[MAX_CHANNELS];
+	Stage *stages = nullptr;
+	int stage_count = 0;
+
+	// Audio thread -> worker thread
+	SPSCRing<float> input[MAX_CHANNELS];
+	float *mix_buffer = nullptr; // Audio thread scratch
+	float *chunk[MAX_CHANNELS] = {}; // Worker scratch
+
+	std::thread worker;
+	std::mutex wake_mutex;
+	std::condition_variable wake_condition;
+	std::atomic<bool> running{ false };
+	std::atomic<bool> pending{ false };
+	std::atomic<uint32_t> underrun_count{ 0 };
+	std::atomic<int> sync_state{ SYNC_RUNNING };
+
+	void _free();
+	void _reset_stages();
+	void _worker_loop();
+	void _process_tails();
+	void _mix_stage(Stage &p_stage, int p_channel, float *p_output);
+
+public:
+	NonUniformConvolver();
+	~NonUniformConvolver();
+
+	NonUniformConvolver(const NonUniformConvolver &) = delete;
+	NonUniformConvolver &operator=(const NonUniformConvolver &) = delete;
+
+	// All channels share p_ir_length; p_head_block must be a valid UniformConvolver block size.
+	// Allocates and starts the worker (when the IR needs tail stages); not realtime safe.
+	Error configure(const float *const *p_irs, int p_channel_count, int p_ir_length, int p_head_block);
+	bool is_valid() const { return channel_count > 0; }
+
+	int get_head_block_size() const { return head_block; }
+	int get_stage_count() const { return stage_count; }
+	int get_stage_block_size(int p_stage) const;
+	int get_partition_count() const;
+	// Blocks where a tail stage was late or muted for a resync
+	uint32_t get_underrun_count() const { return underrun_count.load(std::memory_order_relaxed); }
+
+	// Audio thread: convolves exactly head_block frames per channel, never locks or allocates.
+	// Input and output may alias.
+	void process(const float *const *p_input, float *const *p_output);
+
+	// Any thread: lets the worker exit without waiting for it (the destructor joins it). For a
+	// convolver that will not be processed again but is freed later.
+	void stop();
+};
+
+#endif // NON_UNIFORM_CONVOLVER_H
@@ -0,0 +1,129 @@
+/**************************************************************************/
+/*  uniform_convolver.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "uniform_convolver.h"
+#include "fft_plan_cache.h"
+#include "pffft.h"
+#include <cstring>
+
+static float *_alloc_zeroed(int p_count) {
+	float *buffer = (float *)pffft_aligned_malloc(p_count * sizeof(float));
+	if (buffer != nullptr) {
+		memset(buffer, 0, p_count * sizeof(float));
+	}
+	return buffer;
+}
+
+static void _free_buffer(float *&r_buffer) {
+	if (r_buffer != nullptr) {
+		pffft_aligned_free(r_buffer);
+		r_buffer = nullptr;
+	}
+}
+
+UniformConvolver::UniformConvolver() {
+}
+
+UniformConvolver::~UniformConvolver() {
+	_free();
+}
+
+void UniformConvolver::_free() {
+	if (setup != nullptr) {
+		FFTPlanCache::release(setup);
+		setup = nullptr;
+	}
+
+	_free_buffer(work_buffer);
+	_free_buffer(ir_spectra);
+	_free_buffer(fdl);
+	_free_buffer(input_window);
+	_free_buffer(accumulator);
+	_free_buffer(time_buffer);
+
+	block_size = 0;
+	fft_size = 0;
+	partition_count = 0;
+}
+
+bool UniformConvolver::is_valid_block_size(int p_block_size) {
+	return p_block_size > 0 && pffft_is_valid_size(p_block_size * 2, PFFFT_REAL);
+}
+
+Error UniformConvolver::configure(const float *p_ir, int p_ir_length, int p_block_size) {
+	_free();
+
+	ERR_FAIL_COND_V(p_ir_length <= 0, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!is_valid_block_size(p_block_size), ERR_INVALID_PARAMETER);
+
+	block_size = p_block_size;
+	fft_size = p_block_size * 2;
+	partition_count = (p_ir_length + block_size - 1) / block_size;
+
+	setup = FFTPlanCache::acquire(fft_size, PFFFT_REAL);
+	ERR_FAIL_NULL_V(setup, ERR_CANT_CREATE);
+
+	work_buffer = _alloc_zeroed(fft_size);
+	ir_spectra = _alloc_zeroed(fft_size * partition_count);
+	fdl = _alloc_zeroed(fft_size * partition_count);
+	input_window = _alloc_zeroed(fft_size);
+	accumulator = _alloc_zeroed(fft_size);
+	time_buffer = _alloc_zeroed(fft_size);
+
+	if (!work_buffer || !ir_spectra || !fdl || !input_window || !accumulator || !time_buffer) {
+		_free();
+		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+	}
+
+	// Each partition is zero-padded to the FFT size; spectra stay in pffft's internal order for zconvolve
+	for (int p = 0; p < partition_count; p++) {
+		int offset = p * block_size;
+		int length = MIN(block_size, p_ir_length - offset);
+
+		memset(time_buffer, 0, fft_size * sizeof(float));
+		memcpy(time_buffer, p_ir + offset, length * sizeof(float));
+		pffft_transform(setup, time_buffer, ir_spectra + p * fft_size, work_buffer, PFFFT_FORWARD);
+	}
+
+	reset();
+	return OK;
+}
+
+void UniformConvolver::reset() {
+	if (!is_valid()) {
+		return;
+	}
+
+	memset(fdl, 0, fft_size * partition_count * sizeof(float));
+	memset(input_window, 0, fft_size * sizeof(float));
+	fdl_pos = 0;
+}
+
+void UniformConvolver::process(const float *p_input, float *p_output) {
+	// Slide the input window by one block
+	memcpy(input_window, input_window + block_size, block_size * sizeof(float));
+	memcpy(input_window + block_size, p_input, block_size * sizeof(float));
+
+	// Newest input spectrum goes to the head of the delay line
+	fdl_pos = (fdl_pos == 0) ? partition_count - 1 : fdl_pos - 1;
+	pffft_transform(setup, input_window, fdl + fdl_pos * fft_size, work_buffer, PFFFT_FORWARD);
+
+	// Y = sum(X[k - p] * H[p]); the 1/N inverse scaling is folded into the multiply
+	const float scale = 1.0f / fft_size;
+	int slot = fdl_pos;
+	pffft_zconvolve_no_accu(setup, fdl + slot * fft_size, ir_spectra, accumulator, scale);
+	for (int p = 1; p < partition_count; p++) {
+		slot = (slot + 1 == partition_count) ? 0 : slot + 1;
+		pffft_zconvolve_accumulate(setup, fdl + slot * fft_size, ir_spectra + p * fft_size, accumulator, scale);
+	}
+
+	pffft_transform(setup, accumulator, time_buffer, work_buffer, PFFFT_BACKWARD);
+
+	// Overlap-save: the first half is circularly aliased, the second half is the valid output
+	memcpy(p_output, time_buffer + block_size, block_size * sizeof(float));
+}
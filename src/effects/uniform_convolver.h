@@ -0,0 +1,63 @@
+/**************************************************************************/
+/*  uniform_convolver.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef UNIFORM_CONVOLVER_H
+#define UNIFORM_CONVOLVER_H
+
+#include <godot_cpp/core/error_macros.hpp>
+
+// Forward declare pffft types
+struct PFFFT_Setup;
+typedef struct PFFFT_Setup PFFFT_Setup;
+
+using namespace godot;
+
+// Uniformly partitioned overlap-save convolution of one channel.
+// The impulse response is split into block_size partitions whose spectra are computed once in setup();
+// process() keeps a frequency-domain delay line of past input spectra and multiplies/accumulates them
+// against those partitions with pffft_zconvolve_accumulate. setup() allocates, process() never does.
+class UniformConvolver {
+	PFFFT_Setup *setup = nullptr; // Shared through FFTPlanCache, 2 * block_size real
+	int block_size = 0;
+	int fft_size = 0;
+	int partition_count = 0;
+
+	float *work_buffer = nullptr;
+	float *ir_spectra = nullptr; // partition_count spectra, fft_size floats each, pffft internal order
+	float *fdl = nullptr; // Frequency-domain delay line, same layout as ir_spectra
+	int fdl_pos = 0;
+
+	float *input_window = nullptr; // [previous block | current block]
+	float *accumulator = nullptr;
+	float *time_buffer = nullptr;
+
+	void _free();
+
+public:
+	UniformConvolver();
+	~UniformConvolver();
+
+	UniformConvolver(const UniformConvolver &) = delete;
+	UniformConvolver &operator=(const UniformConvolver &) = delete;
+
+	static bool is_valid_block_size(int p_block_size);
+
+	// p_block_size must make 2 * p_block_size a valid real FFT size
+	Error configure(const float *p_ir, int p_ir_length, int p_block_size);
+	bool is_valid() const { return setup != nullptr; }
+	void reset();
+
+	int get_block_size() const { return block_size; }
+	int get_partition_count() const { return partition_count; }
+
+	// Convolves exactly block_size samples. Output corresponds to the same input block (no extra latency
+	// beyond buffering a full block); p_input and p_output may alias.
+	void process(const float *p_input, float *p_output);
+};
+
+#endif // UNIFORM_CONVOLVER_H
@@ -0,0 +1,72 @@
+/**************************************************************************/
+/*  fft_plan_cache.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "fft_plan_cache.h"
+#include "pffft.h"
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct PlanEntry {
+	int size;
+	int type;
+	PFFFT_Setup *setup;
+	int ref_count;
+};
+
+// A handful of distinct sizes is typical, so a linear scan beats hashing here
+std::mutex plan_mutex;
+std::vector<PlanEntry> plans;
+
+} // namespace
+
+PFFFT_Setup *FFTPlanCache::acquire(int p_size, int p_type) {
+	std::lock_guard<std::mutex> lock(plan_mutex);
+
+	for (PlanEntry &entry : plans) {
+		if (entry.size == p_size && entry.type == p_type) {
+			entry.ref_count++;
+			return entry.setup;
+		}
+	}
+
+	PFFFT_Setup *setup = pffft_new_setup(p_size, (pffft_transform_t)p_type);
+	if (setup == nullptr) {
+		return nullptr;
+	}
+
+	plans.push_back({ p_size, p_type, setup, 1 });
+	return setup;
+}
+
+void FFTPlanCache::release(PFFFT_Setup *p_setup) {
+	if (p_setup == nullptr) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(plan_mutex);
+
+	for (size_t i = 0; i < plans.size(); i++) {
+		if (plans[i].setup != p_setup) {
+			continue;
+		}
+
+		if (--plans[i].ref_count == 0) {
+			pffft_destroy_setup(plans[i].setup);
+			plans[i] = plans.back();
+			plans.pop_back();
+		}
+		return;
+	}
+}
+
+int FFTPlanCache::get_plan_count() {
+	std::lock_guard<std::mutex> lock(plan_mutex);
+	return (int)plans.size();
+}
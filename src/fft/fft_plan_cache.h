@@ -0,0 +1,29 @@
+/**************************************************************************/
+/*  fft_plan_cache.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef FFT_PLAN_CACHE_H
+#define FFT_PLAN_CACHE_H
+
+// Forward declare pffft types
+struct PFFFT_Setup;
+typedef struct PFFFT_Setup PFFFT_Setup;
+
+// Process-wide cache of pffft setups (twiddles + factorization), keyed by size and transform type.
+// Setups are immutable once created, so any number of threads can transform with the same plan
+// as long as each one brings its own work buffer.
+class FFTPlanCache {
+public:
+	// Returns a shared setup, creating it on first use. Every acquire must be paired with a release.
+	static PFFFT_Setup *acquire(int p_size, int p_type);
+	static void release(PFFFT_Setup *p_setup);
+
+	// Number of distinct plans currently alive
+	static int get_plan_count();
+};
+
+#endif // FFT_PLAN_CACHE_H
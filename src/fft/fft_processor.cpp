@@ -7,7 +7,11 @@
 /**************************************************************************/
 
 #include "fft_processor.h"
+#include "fft_plan_cache.h"
+#include "spectrum_kernels.h"
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include "pffft.h"
 #include <cmath>
@@ -22,7 +26,7 @@ FFTProcessor::~FFTProcessor() {
 
 void FFTProcessor::_cleanup() {
 	if (setup != nullptr) {
-		pffft_destroy_setup(setup);
+		FFTPlanCache::release(setup);
 		setup = nullptr;
 	}
 
@@ -31,6 +35,21 @@ void FFTProcessor::_cleanup() {
 		work_buffer = nullptr;
 	}
 
+	if (input_buffer != nullptr) {
+		pffft_aligned_free(input_buffer);
+		input_buffer = nullptr;
+	}
+
+	if (output_buffer != nullptr) {
+		pffft_aligned_free(output_buffer);
+		output_buffer = nullptr;
+	}
+
+	for (float *batch_buffer : batch_buffers) {
+		pffft_aligned_free(batch_buffer);
+	}
+	batch_buffers.clear();
+
 	fft_size = 0;
 }
 
@@ -57,16 +76,27 @@ Error FFTProcessor::setup_fft(int p_size, TransformType p_type) {
 		return ERR_INVALID_PARAMETER;
 	}
 
-	// Create pffft setup
-	setup = pffft_new_setup(p_size, (pffft_transform_t)transform_type);
+	// Share the pffft setup with every other processor of the same size and type
+	setup = FFTPlanCache::acquire(p_size, transform_type);
 	ERR_FAIL_NULL_V(setup, ERR_CANT_CREATE);
 
 	fft_size = p_size;
 
+	// Complex transforms work on N interleaved complex values (2N floats)
+	int float_count = (transform_type == TRANSFORM_REAL) ? p_size : p_size * 2;
+
 	// Allocate work buffer
-	work_buffer = (float *)pffft_aligned_malloc(p_size * sizeof(float));
+	work_buffer = (float *)pffft_aligned_malloc(float_count * sizeof(float));
 	ERR_FAIL_NULL_V(work_buffer, ERR_OUT_OF_MEMORY);
 
+	// Scratch buffers reused by the PackedArray API so it never allocates per call
+	input_buffer = (float *)pffft_aligned_malloc(float_count * sizeof(float));
+	output_buffer = (float *)pffft_aligned_malloc(float_count * sizeof(float));
+	if (input_buffer == nullptr || output_buffer == nullptr) {
+		_cleanup();
+		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+	}
+
 	return OK;
 }
 
@@ -77,13 +107,8 @@ PackedVector2Array FFTProcessor::forward_real(const PackedFloat32Array &p_input)
 	ERR_FAIL_COND_V(transform_type != TRANSFORM_REAL, result);
 	ERR_FAIL_COND_V(p_input.size() != fft_size, result);
 
-	// Allocate input and output buffers
-	float *input_buffer = (float *)pffft_aligned_malloc(fft_size * sizeof(float));
-	float *output_buffer = (float *)pffft_aligned_malloc(fft_size * sizeof(float));
-
-	// Copy input data
-	const float *input_data = p_input.ptr();
-	memcpy(input_buffer, input_data, fft_size * sizeof(float));
+	// Copy input data into the aligned scratch buffer
+	memcpy(input_buffer, p_input.ptr(), fft_size * sizeof(float));
 
 	// Perform FFT
 	pffft_transform_ordered(setup, input_buffer, output_buffer, work_buffer, PFFFT_FORWARD);
@@ -92,24 +117,19 @@ PackedVector2Array FFTProcessor::forward_real(const PackedFloat32Array &p_input)
 	// For real FFT, output format is: [DC, N/2, Re(1), Im(1), Re(2), Im(2), ...]
 	int spectrum_size = fft_size / 2 + 1;
 	result.resize(spectrum_size);
+	Vector2 *result_ptr = result.ptrw();
 
 	// DC component (index 0) - purely real
-	result.set(0, Vector2(output_buffer[0], 0.0f));
+	result_ptr[0] = Vector2(output_buffer[0], 0.0f);
 
 	// Nyquist component (index N/2) - purely real
-	result.set(spectrum_size - 1, Vector2(output_buffer[1], 0.0f));
+	result_ptr[spectrum_size - 1] = Vector2(output_buffer[1], 0.0f);
 
 	// All other components
 	for (int i = 1; i < spectrum_size - 1; i++) {
-		float real = output_buffer[i * 2];
-		float imag = output_buffer[i * 2 + 1];
-		result.set(i, Vector2(real, imag));
+		result_ptr[i] = Vector2(output_buffer[i * 2], output_buffer[i * 2 + 1]);
 	}
 
-	// Cleanup
-	pffft_aligned_free(input_buffer);
-	pffft_aligned_free(output_buffer);
-
 	return result;
 }
 
@@ -122,18 +142,15 @@ PackedFloat32Array FFTProcessor::inverse_real(const PackedVector2Array &p_spectr
 	int expected_spectrum_size = fft_size / 2 + 1;
 	ERR_FAIL_COND_V(p_spectrum.size() != expected_spectrum_size, result);
 
-	// Allocate input and output buffers
-	float *input_buffer = (float *)pffft_aligned_malloc(fft_size * sizeof(float));
-	float *output_buffer = (float *)pffft_aligned_malloc(fft_size * sizeof(float));
-
 	// Convert PackedVector2Array to pffft format
 	// Format: [DC, N/2, Re(1), Im(1), Re(2), Im(2), ...]
-	input_buffer[0] = p_spectrum[0].x; // DC (real only)
-	input_buffer[1] = p_spectrum[expected_spectrum_size - 1].x; // Nyquist (real only)
+	const Vector2 *spectrum_ptr = p_spectrum.ptr();
+	input_buffer[0] = spectrum_ptr[0].x; // DC (real only)
+	input_buffer[1] = spectrum_ptr[expected_spectrum_size - 1].x; // Nyquist (real only)
 
 	for (int i = 1; i < expected_spectrum_size - 1; i++) {
-		input_buffer[i * 2] = p_spectrum[i].x; // Real part
-		input_buffer[i * 2 + 1] = p_spectrum[i].y; // Imaginary part
+		input_buffer[i * 2] = spectrum_ptr[i].x; // Real part
+		input_buffer[i * 2 + 1] = spectrum_ptr[i].y; // Imaginary part
 	}
 
 	// Perform inverse FFT
@@ -141,15 +158,12 @@ PackedFloat32Array FFTProcessor::inverse_real(const PackedVector2Array &p_spectr
 
 	// Copy output and scale by 1/N (pffft doesn't scale)
 	result.resize(fft_size);
+	float *result_ptr = result.ptrw();
 	float scale = 1.0f / fft_size;
 	for (int i = 0; i < fft_size; i++) {
-		result.set(i, output_buffer[i] * scale);
+		result_ptr[i] = output_buffer[i] * scale;
 	}
 
-	// Cleanup
-	pffft_aligned_free(input_buffer);
-	pffft_aligned_free(output_buffer);
-
 	return result;
 }
 
@@ -192,15 +206,261 @@ void FFTProcessor::inverse_real_buffer(const Ref<FFTBuffer> &p_input, const Ref<
 	}
 }
 
+void FFTProcessor::transform_ordered(const float *p_input, float *p_output, Direction p_direction) {
+	ERR_FAIL_COND(!is_valid());
+
+	pffft_transform_ordered(setup, p_input, p_output, work_buffer, p_direction == FORWARD ? PFFFT_FORWARD : PFFFT_BACKWARD);
+}
+
+bool FFTProcessor::_reserve_batch_buffers(int p_task_count) {
+	while ((int)batch_buffers.size() < p_task_count) {
+		float *batch_buffer = (float *)pffft_aligned_malloc(fft_size * 2 * sizeof(float));
+		if (batch_buffer == nullptr) {
+			return false;
+		}
+		batch_buffers.push_back(batch_buffer);
+	}
+	return true;
+}
+
+void FFTProcessor::_forward_batch_task(void *p_userdata, uint32_t p_task_index) {
+	const BatchJob *job = (const BatchJob *)p_userdata;
+	FFTProcessor *processor = job->processor;
+	int size = processor->fft_size;
+
+	// Each task owns a contiguous range of frames and its own work buffer; the plan is shared
+	int first = (int)(((int64_t)job->frame_count * p_task_index) / job->task_count);
+	int last = (int)(((int64_t)job->frame_count * (p_task_index + 1)) / job->task_count);
+
+	float *work = processor->batch_buffers[p_task_index];
+	float *scratch = work + size;
+
+	for (int frame = first; frame < last; frame++) {
+		const float *frame_input = job->input + (int64_t)frame * size;
+
+		// PackedFloat32Array storage has no alignment guarantee, so stage it first
+		if (!job->input_aligned) {
+			memcpy(scratch, frame_input, size * sizeof(float));
+			frame_input = scratch;
+		}
+
+		pffft_transform_ordered(processor->setup, frame_input, job->output + (int64_t)frame * size, work, PFFFT_FORWARD);
+	}
+}
+
+void FFTProcessor::_run_forward_batch(const float *p_input, float *p_output, int p_frame_count, bool p_input_aligned) {
+	int task_count = MIN(p_frame_count, MAX(OS::get_singleton()->get_processor_count(), 1));
+	ERR_FAIL_COND(!_reserve_batch_buffers(task_count));
+
+	BatchJob job;
+	job.processor = this;
+	job.input = p_input;
+	job.output = p_output;
+	job.frame_count = p_frame_count;
+	job.task_count = task_count;
+	job.input_aligned = p_input_aligned;
+
+	// Not worth a round trip through the pool
+	if (task_count == 1) {
+		_forward_batch_task(&job, 0);
+		return;
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int64_t group_id = pool->add_native_group_task(&FFTProcessor::_forward_batch_task, &job, task_count, task_count, true, "FFTProcessor batch");
+	pool->wait_for_group_task_completion(group_id);
+}
+
+void FFTProcessor::forward_real_batch(const Ref<FFTBuffer> &p_input, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(transform_type != TRANSFORM_REAL);
+	ERR_FAIL_COND(p_input.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND_MSG(p_input->get_size() % fft_size != 0, "Batch input size must be a multiple of the FFT size.");
+
+	int frame_count = p_input->get_size() / fft_size;
+	if (frame_count == 0) {
+		return;
+	}
+
+	p_output->resize(p_input->get_size());
+
+	_run_forward_batch(p_input->get_buffer_ptr(), p_output->get_buffer_ptr(), frame_count, true);
+}
+
+void FFTProcessor::forward_real_batch_array(const PackedFloat32Array &p_input, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(transform_type != TRANSFORM_REAL);
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND_MSG(p_input.size() % fft_size != 0, "Batch input size must be a multiple of the FFT size.");
+
+	int frame_count = p_input.size() / fft_size;
+	if (frame_count == 0) {
+		return;
+	}
+
+	p_output->resize(p_input.size());
+
+	_run_forward_batch(p_input.ptr(), p_output->get_buffer_ptr(), frame_count, false);
+}
+
+PackedVector2Array FFTProcessor::forward_complex(const PackedVector2Array &p_input) {
+	PackedVector2Array result;
+
+	ERR_FAIL_COND_V(!is_valid(), result);
+	ERR_FAIL_COND_V(transform_type != TRANSFORM_COMPLEX, result);
+	ERR_FAIL_COND_V(p_input.size() != fft_size, result);
+
+	// Interleave [Re, Im] into the aligned scratch buffer
+	const Vector2 *input_ptr = p_input.ptr();
+	for (int i = 0; i < fft_size; i++) {
+		input_buffer[i * 2] = input_ptr[i].x;
+		input_buffer[i * 2 + 1] = input_ptr[i].y;
+	}
+
+	pffft_transform_ordered(setup, input_buffer, output_buffer, work_buffer, PFFFT_FORWARD);
+
+	result.resize(fft_size);
+	Vector2 *result_ptr = result.ptrw();
+	for (int i = 0; i < fft_size; i++) {
+		result_ptr[i] = Vector2(output_buffer[i * 2], output_buffer[i * 2 + 1]);
+	}
+
+	return result;
+}
+
+PackedVector2Array FFTProcessor::inverse_complex(const PackedVector2Array &p_spectrum) {
+	PackedVector2Array result;
+
+	ERR_FAIL_COND_V(!is_valid(), result);
+	ERR_FAIL_COND_V(transform_type != TRANSFORM_COMPLEX, result);
+	ERR_FAIL_COND_V(p_spectrum.size() != fft_size, result);
+
+	const Vector2 *spectrum_ptr = p_spectrum.ptr();
+	for (int i = 0; i < fft_size; i++) {
+		input_buffer[i * 2] = spectrum_ptr[i].x;
+		input_buffer[i * 2 + 1] = spectrum_ptr[i].y;
+	}
+
+	pffft_transform_ordered(setup, input_buffer, output_buffer, work_buffer, PFFFT_BACKWARD);
+
+	// Scale by 1/N (pffft doesn't scale)
+	result.resize(fft_size);
+	Vector2 *result_ptr = result.ptrw();
+	float scale = 1.0f / fft_size;
+	for (int i = 0; i < fft_size; i++) {
+		result_ptr[i] = Vector2(output_buffer[i * 2] * scale, output_buffer[i * 2 + 1] * scale);
+	}
+
+	return result;
+}
+
+void FFTProcessor::forward_complex_buffer(const Ref<FFTBuffer> &p_input, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(transform_type != TRANSFORM_COMPLEX);
+	ERR_FAIL_COND(p_input.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_input->get_size() != fft_size * 2);
+	ERR_FAIL_COND(p_output->get_size() != fft_size * 2);
+
+	// Perform FFT directly on buffers
+	pffft_transform_ordered(setup,
+			p_input->get_buffer_ptr(),
+			p_output->get_buffer_ptr(),
+			work_buffer,
+			PFFFT_FORWARD);
+}
+
+void FFTProcessor::inverse_complex_buffer(const Ref<FFTBuffer> &p_input, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(transform_type != TRANSFORM_COMPLEX);
+	ERR_FAIL_COND(p_input.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_input->get_size() != fft_size * 2);
+	ERR_FAIL_COND(p_output->get_size() != fft_size * 2);
+
+	// Perform inverse FFT
+	pffft_transform_ordered(setup,
+			p_input->get_buffer_ptr(),
+			p_output->get_buffer_ptr(),
+			work_buffer,
+			PFFFT_BACKWARD);
+
+	// Scale by 1/N
+	float scale = 1.0f / fft_size;
+	float *output_ptr = p_output->get_buffer_ptr();
+	for (int i = 0; i < fft_size * 2; i++) {
+		output_ptr[i] *= scale;
+	}
+}
+
+void FFTProcessor::_forward_real_interleaved(const float *p_input, float *p_output) {
+	// pffft's ordered output already stores bins 1..N/2-1 as [Re, Im] pairs at index 2 onwards,
+	// so transform straight into the destination and move the packed Nyquist term to the end.
+	memcpy(input_buffer, p_input, fft_size * sizeof(float));
+	pffft_transform_ordered(setup, input_buffer, p_output, work_buffer, PFFFT_FORWARD);
+
+	float nyquist = p_output[1];
+	p_output[1] = 0.0f;
+	p_output[fft_size] = nyquist;
+	p_output[fft_size + 1] = 0.0f;
+}
+
+void FFTProcessor::_inverse_real_interleaved(const float *p_spectrum, float *p_output) {
+	// Repack to pffft's ordered format: [DC, N/2, Re(1), Im(1), ...]
+	memcpy(input_buffer, p_spectrum, fft_size * sizeof(float));
+	input_buffer[1] = p_spectrum[fft_size];
+
+	pffft_transform_ordered(setup, input_buffer, p_output, work_buffer, PFFFT_BACKWARD);
+
+	float scale = 1.0f / fft_size;
+	for (int i = 0; i < fft_size; i++) {
+		p_output[i] *= scale;
+	}
+}
+
+void FFTProcessor::forward_real_interleaved(const PackedFloat32Array &p_input, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(transform_type != TRANSFORM_REAL);
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_input.size() != fft_size);
+
+	// Only allocates when the destination has never been sized for this FFT
+	p_output->resize(get_interleaved_size());
+
+	_forward_real_interleaved(p_input.ptr(), p_output->get_buffer_ptr());
+}
+
+void FFTProcessor::inverse_real_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(transform_type != TRANSFORM_REAL);
+	ERR_FAIL_COND(p_spectrum.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_spectrum->get_size() != get_interleaved_size());
+	ERR_FAIL_COND_MSG(p_spectrum == p_output, "The output buffer must not be the spectrum buffer; resizing it would discard the spectrum.");
+
+	p_output->resize(fft_size);
+
+	_inverse_real_interleaved(p_spectrum->get_buffer_ptr(), p_output->get_buffer_ptr());
+}
+
+int FFTProcessor::get_interleaved_size() const {
+	if (!is_valid() || transform_type != TRANSFORM_REAL) {
+		return 0;
+	}
+
+	return (fft_size / 2 + 1) * 2;
+}
+
 PackedFloat32Array FFTProcessor::get_magnitude_spectrum(const PackedVector2Array &p_spectrum) {
 	PackedFloat32Array result;
 	int size = p_spectrum.size();
 	result.resize(size);
 
+	const Vector2 *spectrum_ptr = p_spectrum.ptr();
+	float *result_ptr = result.ptrw();
 	for (int i = 0; i < size; i++) {
-		Vector2 complex = p_spectrum[i];
-		float magnitude = sqrt(complex.x * complex.x + complex.y * complex.y);
-		result.set(i, magnitude);
+		result_ptr[i] = spectrum_ptr[i].length();
 	}
 
 	return result;
@@ -211,10 +471,10 @@ PackedFloat32Array FFTProcessor::get_phase_spectrum(const PackedVector2Array &p_
 	int size = p_spectrum.size();
 	result.resize(size);
 
+	const Vector2 *spectrum_ptr = p_spectrum.ptr();
+	float *result_ptr = result.ptrw();
 	for (int i = 0; i < size; i++) {
-		Vector2 complex = p_spectrum[i];
-		float phase = atan2(complex.y, complex.x);
-		result.set(i, phase);
+		result_ptr[i] = atan2(spectrum_ptr[i].y, spectrum_ptr[i].x);
 	}
 
 	return result;
@@ -225,15 +485,97 @@ PackedFloat32Array FFTProcessor::get_power_spectrum(const PackedVector2Array &p_
 	int size = p_spectrum.size();
 	result.resize(size);
 
+	const Vector2 *spectrum_ptr = p_spectrum.ptr();
+	float *result_ptr = result.ptrw();
 	for (int i = 0; i < size; i++) {
-		Vector2 complex = p_spectrum[i];
-		float power = complex.x * complex.x + complex.y * complex.y;
-		result.set(i, power);
+		result_ptr[i] = spectrum_ptr[i].length_squared();
 	}
 
 	return result;
 }
 
+void FFTProcessor::get_magnitude_spectrum_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(p_spectrum.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_spectrum->get_size() % 2 != 0);
+	ERR_FAIL_COND_MSG(p_spectrum == p_output, "The output buffer must not be the spectrum buffer.");
+
+	int bins = p_spectrum->get_size() / 2;
+	p_output->resize(bins);
+
+	SpectrumKernels::magnitude(p_spectrum->get_buffer_ptr(), p_output->get_buffer_ptr(), bins);
+}
+
+void FFTProcessor::get_phase_spectrum_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(p_spectrum.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_spectrum->get_size() % 2 != 0);
+	ERR_FAIL_COND_MSG(p_spectrum == p_output, "The output buffer must not be the spectrum buffer.");
+
+	int bins = p_spectrum->get_size() / 2;
+	p_output->resize(bins);
+
+	SpectrumKernels::phase(p_spectrum->get_buffer_ptr(), p_output->get_buffer_ptr(), bins);
+}
+
+void FFTProcessor::get_power_spectrum_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(p_spectrum.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_spectrum->get_size() % 2 != 0);
+	ERR_FAIL_COND_MSG(p_spectrum == p_output, "The output buffer must not be the spectrum buffer.");
+
+	int bins = p_spectrum->get_size() / 2;
+	p_output->resize(bins);
+
+	SpectrumKernels::power(p_spectrum->get_buffer_ptr(), p_output->get_buffer_ptr(), bins);
+}
+
+void FFTProcessor::get_db_spectrum_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output, float p_floor_db) {
+	ERR_FAIL_COND(p_spectrum.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_spectrum->get_size() % 2 != 0);
+	ERR_FAIL_COND_MSG(p_spectrum == p_output, "The output buffer must not be the spectrum buffer.");
+
+	int bins = p_spectrum->get_size() / 2;
+	p_output->resize(bins);
+
+	SpectrumKernels::decibels(p_spectrum->get_buffer_ptr(), p_output->get_buffer_ptr(), bins, p_floor_db);
+}
+
+void FFTProcessor::_process_spectrum_buffer(int p_kind, const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output, float p_floor_db) {
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(p_spectrum.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND_MSG(p_spectrum == p_output, "The output buffer must not be the spectrum buffer.");
+
+	SpectrumKernels::Kind kind = (SpectrumKernels::Kind)p_kind;
+	if (transform_type == TRANSFORM_REAL) {
+		ERR_FAIL_COND(p_spectrum->get_size() != fft_size);
+		p_output->resize(fft_size / 2 + 1);
+		SpectrumKernels::process_ordered_real(kind, p_spectrum->get_buffer_ptr(), p_output->get_buffer_ptr(), fft_size, p_floor_db);
+	} else {
+		ERR_FAIL_COND(p_spectrum->get_size() != fft_size * 2);
+		p_output->resize(fft_size);
+		SpectrumKernels::process_interleaved(kind, p_spectrum->get_buffer_ptr(), p_output->get_buffer_ptr(), fft_size, p_floor_db);
+	}
+}
+
+void FFTProcessor::get_magnitude_spectrum_buffer(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output) {
+	_process_spectrum_buffer(SpectrumKernels::KIND_MAGNITUDE, p_spectrum, p_output, 0.0f);
+}
+
+void FFTProcessor::get_power_spectrum_buffer(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output) {
+	_process_spectrum_buffer(SpectrumKernels::KIND_POWER, p_spectrum, p_output, 0.0f);
+}
+
+void FFTProcessor::get_db_spectrum_buffer(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output, float p_floor_db) {
+	_process_spectrum_buffer(SpectrumKernels::KIND_DB, p_spectrum, p_output, p_floor_db);
+}
+
+void FFTProcessor::get_phase_spectrum_buffer(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output) {
+	_process_spectrum_buffer(SpectrumKernels::KIND_PHASE, p_spectrum, p_output, 0.0f);
+}
+
 int FFTProcessor::get_spectrum_size() const {
 	if (!is_valid()) {
 		return 0;
@@ -263,6 +605,10 @@ int FFTProcessor::get_minimum_fft_size(TransformType p_type) {
 	return (p_type == TRANSFORM_REAL) ? 32 : 16;
 }
 
+int FFTProcessor::get_cached_plan_count() {
+	return FFTPlanCache::get_plan_count();
+}
+
 void FFTProcessor::_bind_methods() {
 	// Setup
 	ClassDB::bind_method(D_METHOD("setup_fft", "size", "type"), &FFTProcessor::setup_fft, DEFVAL(TRANSFORM_REAL));
@@ -278,16 +624,40 @@ void FFTProcessor::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("forward_real_buffer", "input", "output"), &FFTProcessor::forward_real_buffer);
 	ClassDB::bind_method(D_METHOD("inverse_real_buffer", "input", "output"), &FFTProcessor::inverse_real_buffer);
 
+	// Batch operations
+	ClassDB::bind_method(D_METHOD("forward_real_batch", "input", "output"), &FFTProcessor::forward_real_batch);
+	ClassDB::bind_method(D_METHOD("forward_real_batch_array", "input", "output"), &FFTProcessor::forward_real_batch_array);
+
+	// Complex operations
+	ClassDB::bind_method(D_METHOD("forward_complex", "input"), &FFTProcessor::forward_complex);
+	ClassDB::bind_method(D_METHOD("inverse_complex", "spectrum"), &FFTProcessor::inverse_complex);
+	ClassDB::bind_method(D_METHOD("forward_complex_buffer", "input", "output"), &FFTProcessor::forward_complex_buffer);
+	ClassDB::bind_method(D_METHOD("inverse_complex_buffer", "input", "output"), &FFTProcessor::inverse_complex_buffer);
+
+	// Interleaved operations
+	ClassDB::bind_method(D_METHOD("forward_real_interleaved", "input", "output"), &FFTProcessor::forward_real_interleaved);
+	ClassDB::bind_method(D_METHOD("inverse_real_interleaved", "spectrum", "output"), &FFTProcessor::inverse_real_interleaved);
+	ClassDB::bind_method(D_METHOD("get_interleaved_size"), &FFTProcessor::get_interleaved_size);
+
 	// Utility functions
 	ClassDB::bind_method(D_METHOD("get_magnitude_spectrum", "spectrum"), &FFTProcessor::get_magnitude_spectrum);
 	ClassDB::bind_method(D_METHOD("get_phase_spectrum", "spectrum"), &FFTProcessor::get_phase_spectrum);
 	ClassDB::bind_method(D_METHOD("get_power_spectrum", "spectrum"), &FFTProcessor::get_power_spectrum);
 	ClassDB::bind_method(D_METHOD("get_spectrum_size"), &FFTProcessor::get_spectrum_size);
+	ClassDB::bind_method(D_METHOD("get_magnitude_spectrum_interleaved", "spectrum", "output"), &FFTProcessor::get_magnitude_spectrum_interleaved);
+	ClassDB::bind_method(D_METHOD("get_phase_spectrum_interleaved", "spectrum", "output"), &FFTProcessor::get_phase_spectrum_interleaved);
+	ClassDB::bind_method(D_METHOD("get_power_spectrum_interleaved", "spectrum", "output"), &FFTProcessor::get_power_spectrum_interleaved);
+	ClassDB::bind_method(D_METHOD("get_db_spectrum_interleaved", "spectrum", "output", "floor_db"), &FFTProcessor::get_db_spectrum_interleaved, DEFVAL(-120.0f));
+	ClassDB::bind_method(D_METHOD("get_magnitude_spectrum_buffer", "spectrum", "output"), &FFTProcessor::get_magnitude_spectrum_buffer);
+	ClassDB::bind_method(D_METHOD("get_power_spectrum_buffer", "spectrum", "output"), &FFTProcessor::get_power_spectrum_buffer);
+	ClassDB::bind_method(D_METHOD("get_db_spectrum_buffer", "spectrum", "output", "floor_db"), &FFTProcessor::get_db_spectrum_buffer, DEFVAL(-120.0f));
+	ClassDB::bind_method(D_METHOD("get_phase_spectrum_buffer", "spectrum", "output"), &FFTProcessor::get_phase_spectrum_buffer);
 
 	// Static functions
 	ClassDB::bind_static_method("FFTProcessor", D_METHOD("is_valid_fft_size", "size", "type"), &FFTProcessor::is_valid_fft_size, DEFVAL(TRANSFORM_REAL));
 	ClassDB::bind_static_method("FFTProcessor", D_METHOD("get_nearest_valid_size", "size", "type", "higher"), &FFTProcessor::get_nearest_valid_size, DEFVAL(TRANSFORM_REAL), DEFVAL(true));
 	ClassDB::bind_static_method("FFTProcessor", D_METHOD("get_minimum_fft_size", "type"), &FFTProcessor::get_minimum_fft_size, DEFVAL(TRANSFORM_REAL));
+	ClassDB::bind_static_method("FFTProcessor", D_METHOD("get_cached_plan_count"), &FFTProcessor::get_cached_plan_count);
 
 	// Enums
 	BIND_ENUM_CONSTANT(TRANSFORM_REAL);
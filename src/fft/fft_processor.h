@@ -15,6 +15,8 @@
 
 #include "fft_buffer.h"
 
+#include <vector>
+
 // Forward declare pffft types
 struct PFFFT_Setup;
 typedef struct PFFFT_Setup PFFFT_Setup;
@@ -36,14 +38,37 @@ public:
 	};
 
 private:
-	PFFFT_Setup *setup = nullptr;
+	PFFFT_Setup *setup = nullptr; // Shared through FFTPlanCache, never modified
 	float *work_buffer = nullptr;
+	float *input_buffer = nullptr; // Scratch for the PackedArray API, sized in setup_fft
+	float *output_buffer = nullptr;
+	std::vector<float *> batch_buffers; // One [work | input] block per batch task, grown on demand
+
+	struct BatchJob {
+		FFTProcessor *processor = nullptr;
+		const float *input = nullptr;
+		float *output = nullptr;
+		int frame_count = 0;
+		int task_count = 0;
+		bool input_aligned = false;
+	};
 	int fft_size = 0;
 	TransformType transform_type = TRANSFORM_REAL;
 
 	void _cleanup();
 	bool _validate_size(int p_size) const;
 
+	// Interleaved [re, im] helpers shared by the PackedArray and FFTBuffer paths
+	void _forward_real_interleaved(const float *p_input, float *p_output);
+	void _inverse_real_interleaved(const float *p_spectrum, float *p_output);
+
+	void _process_spectrum_buffer(int p_kind, const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output, float p_floor_db);
+
+	// Batch helpers
+	bool _reserve_batch_buffers(int p_task_count);
+	void _run_forward_batch(const float *p_input, float *p_output, int p_frame_count, bool p_input_aligned);
+	static void _forward_batch_task(void *p_userdata, uint32_t p_task_index);
+
 protected:
 	static void _bind_methods();
 
@@ -65,16 +90,49 @@ public:
 	void forward_real_buffer(const Ref<FFTBuffer> &p_input, const Ref<FFTBuffer> &p_output);
 	void inverse_real_buffer(const Ref<FFTBuffer> &p_input, const Ref<FFTBuffer> &p_output);
 
+	// Direct access (for native callers; pointers must come from pffft_aligned_malloc, output is unscaled)
+	void transform_ordered(const float *p_input, float *p_output, Direction p_direction);
+
+	// Batch operations (K contiguous frames of N samples in, K ordered spectra of N floats out, spread across WorkerThreadPool)
+	void forward_real_batch(const Ref<FFTBuffer> &p_input, const Ref<FFTBuffer> &p_output);
+	void forward_real_batch_array(const PackedFloat32Array &p_input, const Ref<FFTBuffer> &p_output);
+
+	// Complex operations (TRANSFORM_COMPLEX setups, N complex values in and out)
+	PackedVector2Array forward_complex(const PackedVector2Array &p_input);
+	PackedVector2Array inverse_complex(const PackedVector2Array &p_spectrum);
+	void forward_complex_buffer(const Ref<FFTBuffer> &p_input, const Ref<FFTBuffer> &p_output);
+	void inverse_complex_buffer(const Ref<FFTBuffer> &p_input, const Ref<FFTBuffer> &p_output);
+
+	// Interleaved operations ([re, im] float pairs, N/2 + 1 bins, no allocation after the first call)
+	void forward_real_interleaved(const PackedFloat32Array &p_input, const Ref<FFTBuffer> &p_output);
+	// p_output must be a different buffer from p_spectrum
+	void inverse_real_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output);
+	int get_interleaved_size() const;
+
 	// Utility functions
 	PackedFloat32Array get_magnitude_spectrum(const PackedVector2Array &p_spectrum);
 	PackedFloat32Array get_phase_spectrum(const PackedVector2Array &p_spectrum);
 	PackedFloat32Array get_power_spectrum(const PackedVector2Array &p_spectrum);
 	int get_spectrum_size() const;
 
+	// Utility functions over the interleaved layout. These and the _buffer variants write into a
+	// separate output buffer; passing the spectrum buffer as the output is an error.
+	void get_magnitude_spectrum_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output);
+	void get_phase_spectrum_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output);
+	void get_power_spectrum_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output);
+	void get_db_spectrum_interleaved(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output, float p_floor_db = -120.0f);
+
+	// SIMD utility functions over the ordered output of forward_real_buffer / forward_complex_buffer
+	void get_magnitude_spectrum_buffer(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output);
+	void get_power_spectrum_buffer(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output);
+	void get_db_spectrum_buffer(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output, float p_floor_db = -120.0f);
+	void get_phase_spectrum_buffer(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output);
+
 	// Static utility functions
 	static bool is_valid_fft_size(int p_size, TransformType p_type = TRANSFORM_REAL);
 	static int get_nearest_valid_size(int p_size, TransformType p_type = TRANSFORM_REAL, bool p_higher = true);
 	static int get_minimum_fft_size(TransformType p_type = TRANSFORM_REAL);
+	static int get_cached_plan_count();
 };
 
 VARIANT_ENUM_CAST(FFTProcessor::TransformType);
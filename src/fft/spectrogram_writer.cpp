@@ -0,0 +1,223 @@
+/**************************************************************************/
+/*  spectrogram_writer.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "spectrogram_writer.h"
+#include "spectrum_kernels.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <cmath>
+#include <cstring>
+
+static uint32_t _pack_rgba8(float p_r, float p_g, float p_b, float p_a) {
+	uint8_t bytes[4] = {
+		(uint8_t)CLAMP((int)lrintf(p_r * 255.0f), 0, 255),
+		(uint8_t)CLAMP((int)lrintf(p_g * 255.0f), 0, 255),
+		(uint8_t)CLAMP((int)lrintf(p_b * 255.0f), 0, 255),
+		(uint8_t)CLAMP((int)lrintf(p_a * 255.0f), 0, 255),
+	};
+	uint32_t packed;
+	memcpy(&packed, bytes, sizeof(packed));
+	return packed;
+}
+
+SpectrogramWriter::SpectrogramWriter() {
+	_rebuild_lut();
+}
+
+SpectrogramWriter::~SpectrogramWriter() {
+}
+
+void SpectrogramWriter::_rebuild_lut() {
+	// Default ramp: black -> blue -> magenta -> orange -> white
+	static const float ramp[5][3] = {
+		{ 0.0f, 0.0f, 0.0f },
+		{ 0.1f, 0.0f, 0.5f },
+		{ 0.7f, 0.0f, 0.5f },
+		{ 1.0f, 0.6f, 0.0f },
+		{ 1.0f, 1.0f, 1.0f },
+	};
+
+	for (int i = 0; i < LUT_SIZE; i++) {
+		float t = i / (float)(LUT_SIZE - 1);
+		if (gradient.is_valid()) {
+			Color c = gradient->sample(t);
+			color_lut[i] = _pack_rgba8(c.r, c.g, c.b, c.a);
+		} else {
+			float x = t * 4.0f;
+			int segment = MIN((int)x, 3);
+			float f = x - segment;
+			color_lut[i] = _pack_rgba8(
+					ramp[segment][0] + (ramp[segment + 1][0] - ramp[segment][0]) * f,
+					ramp[segment][1] + (ramp[segment + 1][1] - ramp[segment][1]) * f,
+					ramp[segment][2] + (ramp[segment + 1][2] - ramp[segment][2]) * f,
+					1.0f);
+		}
+	}
+}
+
+Error SpectrogramWriter::setup(int p_bin_count, int p_history_length) {
+	ERR_FAIL_COND_V(p_bin_count < 1 || p_bin_count > 16384, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_history_length < 1 || p_history_length > 16384, ERR_INVALID_PARAMETER);
+
+	texture.unref();
+	bin_count = p_bin_count;
+	history_length = p_history_length;
+	write_column = 0;
+	dirty_tiles = 0;
+	db_scratch.assign(bin_count, 0.0f);
+
+	// The last tile may be only partly used; the shader never samples past history_length
+	int tile_count = (history_length + TILE_WIDTH - 1) / TILE_WIDTH;
+	tiles.resize(tile_count);
+	tile_dirty.assign(tile_count, 0);
+
+	TypedArray<Ref<Image>> layers;
+	for (int i = 0; i < tile_count; i++) {
+		tiles[i] = Image::create_empty(TILE_WIDTH, bin_count, false, Image::FORMAT_RGBA8);
+		ERR_FAIL_COND_V(tiles[i].is_null(), ERR_CANT_CREATE);
+
+		uint32_t *pixels = (uint32_t *)tiles[i]->ptrw();
+		for (int j = 0; j < TILE_WIDTH * bin_count; j++) {
+			pixels[j] = color_lut[0];
+		}
+		layers.push_back(tiles[i]);
+	}
+
+	Ref<Texture2DArray> new_texture;
+	new_texture.instantiate();
+	Error err = new_texture->create_from_images(layers);
+	ERR_FAIL_COND_V(err != OK, err);
+
+	texture = new_texture;
+	return OK;
+}
+
+void SpectrogramWriter::clear() {
+	ERR_FAIL_COND(!is_valid());
+
+	for (int i = 0; i < (int)tiles.size(); i++) {
+		uint32_t *pixels = (uint32_t *)tiles[i]->ptrw();
+		for (int j = 0; j < TILE_WIDTH * bin_count; j++) {
+			pixels[j] = color_lut[0];
+		}
+		_mark_dirty(i);
+	}
+}
+
+void SpectrogramWriter::_mark_dirty(int p_tile) {
+	if (!tile_dirty[p_tile]) {
+		tile_dirty[p_tile] = 1;
+		dirty_tiles++;
+	}
+}
+
+void SpectrogramWriter::set_min_db(float p_db) {
+	min_db = p_db;
+}
+
+void SpectrogramWriter::set_max_db(float p_db) {
+	max_db = p_db;
+}
+
+void SpectrogramWriter::set_gradient(const Ref<Gradient> &p_gradient) {
+	gradient = p_gradient;
+	_rebuild_lut();
+}
+
+void SpectrogramWriter::push_magnitudes_ptr(const float *p_magnitudes) {
+	ERR_FAIL_COND(!is_valid());
+
+	SpectrumKernels::amplitude_to_db(p_magnitudes, db_scratch.data(), bin_count, min_db);
+
+	// Map [min_db, max_db] onto the LUT and write one column, DC at the bottom. The setters store
+	// what they are given, so the order properties are set or loaded in does not matter; a range
+	// that is empty or inverted is widened to 1 dB above min_db here.
+	float top_db = MAX(max_db, min_db + 1.0f);
+	float lut_scale = (LUT_SIZE - 1) / (top_db - min_db);
+	int tile = write_column / TILE_WIDTH;
+	uint32_t *pixels = (uint32_t *)tiles[tile]->ptrw();
+	uint32_t *column = pixels + (write_column % TILE_WIDTH) + (int64_t)(bin_count - 1) * TILE_WIDTH;
+	for (int k = 0; k < bin_count; k++) {
+		int index = (int)((db_scratch[k] - min_db) * lut_scale);
+		*column = color_lut[CLAMP(index, 0, LUT_SIZE - 1)];
+		column -= TILE_WIDTH;
+	}
+
+	_mark_dirty(tile);
+	write_column = (write_column + 1) % history_length;
+}
+
+void SpectrogramWriter::push_magnitudes(const Ref<FFTBuffer> &p_magnitudes) {
+	ERR_FAIL_COND(p_magnitudes.is_null());
+	ERR_FAIL_COND(p_magnitudes->get_size() != bin_count);
+
+	push_magnitudes_ptr(p_magnitudes->get_buffer_ptr());
+}
+
+void SpectrogramWriter::push_magnitudes_array(const PackedFloat32Array &p_magnitudes) {
+	ERR_FAIL_COND(p_magnitudes.size() != bin_count);
+
+	push_magnitudes_ptr(p_magnitudes.ptr());
+}
+
+bool SpectrogramWriter::update_texture() {
+	if (!is_valid() || dirty_tiles == 0) {
+		return false;
+	}
+
+	// One layer upload per touched tile, however many of its columns were pushed since the last call
+	for (int i = 0; i < (int)tiles.size(); i++) {
+		if (tile_dirty[i]) {
+			texture->update_layer(tiles[i], i);
+			tile_dirty[i] = 0;
+		}
+	}
+	dirty_tiles = 0;
+	return true;
+}
+
+float SpectrogramWriter::get_scroll_offset() const {
+	if (history_length == 0) {
+		return 0.0f;
+	}
+	return write_column / (float)history_length;
+}
+
+void SpectrogramWriter::_bind_methods() {
+	// Setup
+	ClassDB::bind_method(D_METHOD("setup", "bin_count", "history_length"), &SpectrogramWriter::setup);
+	ClassDB::bind_method(D_METHOD("is_valid"), &SpectrogramWriter::is_valid);
+	ClassDB::bind_method(D_METHOD("clear"), &SpectrogramWriter::clear);
+	ClassDB::bind_method(D_METHOD("get_bin_count"), &SpectrogramWriter::get_bin_count);
+	ClassDB::bind_method(D_METHOD("get_history_length"), &SpectrogramWriter::get_history_length);
+	ClassDB::bind_method(D_METHOD("get_tile_width"), &SpectrogramWriter::get_tile_width);
+	ClassDB::bind_method(D_METHOD("get_tile_count"), &SpectrogramWriter::get_tile_count);
+
+	ClassDB::bind_method(D_METHOD("set_min_db", "db"), &SpectrogramWriter::set_min_db);
+	ClassDB::bind_method(D_METHOD("get_min_db"), &SpectrogramWriter::get_min_db);
+	ClassDB::bind_method(D_METHOD("set_max_db", "db"), &SpectrogramWriter::set_max_db);
+	ClassDB::bind_method(D_METHOD("get_max_db"), &SpectrogramWriter::get_max_db);
+	ClassDB::bind_method(D_METHOD("set_gradient", "gradient"), &SpectrogramWriter::set_gradient);
+	ClassDB::bind_method(D_METHOD("get_gradient"), &SpectrogramWriter::get_gradient);
+
+	// Writing
+	ClassDB::bind_method(D_METHOD("push_magnitudes", "magnitudes"), &SpectrogramWriter::push_magnitudes);
+	ClassDB::bind_method(D_METHOD("push_magnitudes_array", "magnitudes"), &SpectrogramWriter::push_magnitudes_array);
+
+	// Display
+	ClassDB::bind_method(D_METHOD("update_texture"), &SpectrogramWriter::update_texture);
+	ClassDB::bind_method(D_METHOD("get_texture"), &SpectrogramWriter::get_texture);
+	ClassDB::bind_method(D_METHOD("get_write_column"), &SpectrogramWriter::get_write_column);
+	ClassDB::bind_method(D_METHOD("get_scroll_offset"), &SpectrogramWriter::get_scroll_offset);
+
+	// Properties
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "min_db", PROPERTY_HINT_RANGE, "-160.0,0.0,0.1,suffix:dB"), "set_min_db", "get_min_db");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "max_db", PROPERTY_HINT_RANGE, "-120.0,40.0,0.1,suffix:dB"), "set_max_db", "get_max_db");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "gradient", PROPERTY_HINT_RESOURCE_TYPE, "Gradient"), "set_gradient", "get_gradient");
+}
@@ -0,0 +1,93 @@
+/**************************************************************************/
+/*  spectrogram_writer.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef SPECTROGRAM_WRITER_H
+#define SPECTROGRAM_WRITER_H
+
+#include <godot_cpp/classes/gradient.hpp>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/texture2d_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+#include "fft_buffer.h"
+
+#include <vector>
+
+using namespace godot;
+
+// Writes magnitude spectra as colored columns into a circular RGBA8 image.
+// The ring is split into tiles of TILE_WIDTH columns, one Texture2DArray layer each. Columns go straight
+// into the tile Images' pixel buffers; update_texture() uploads only the tiles touched since the last call.
+class SpectrogramWriter : public RefCounted {
+	GDCLASS(SpectrogramWriter, RefCounted);
+
+public:
+	static const int TILE_WIDTH = 16;
+
+private:
+	static const int LUT_SIZE = 256;
+
+	std::vector<Ref<Image>> tiles;
+	std::vector<uint8_t> tile_dirty;
+	Ref<Texture2DArray> texture;
+	Ref<Gradient> gradient;
+
+	int history_length = 0; // Ring width (columns)
+	int bin_count = 0; // Ring height (rows)
+	int write_column = 0;
+	int dirty_tiles = 0;
+
+	float min_db = -90.0f;
+	float max_db = 0.0f;
+
+	uint32_t color_lut[LUT_SIZE];
+	std::vector<float> db_scratch;
+
+	void _rebuild_lut();
+	void _mark_dirty(int p_tile);
+
+protected:
+	static void _bind_methods();
+
+public:
+	SpectrogramWriter();
+	~SpectrogramWriter();
+
+	// Setup
+	Error setup(int p_bin_count, int p_history_length);
+	bool is_valid() const { return texture.is_valid(); }
+	void clear();
+
+	int get_bin_count() const { return bin_count; }
+	int get_history_length() const { return history_length; }
+	int get_tile_width() const { return TILE_WIDTH; }
+	int get_tile_count() const { return (int)tiles.size(); }
+
+	void set_min_db(float p_db);
+	float get_min_db() const { return min_db; }
+
+	void set_max_db(float p_db);
+	float get_max_db() const { return max_db; }
+
+	void set_gradient(const Ref<Gradient> &p_gradient);
+	Ref<Gradient> get_gradient() const { return gradient; }
+
+	// Writing (linear magnitudes, bin_count floats, DC at the bottom row)
+	void push_magnitudes(const Ref<FFTBuffer> &p_magnitudes);
+	void push_magnitudes_array(const PackedFloat32Array &p_magnitudes);
+	void push_magnitudes_ptr(const float *p_magnitudes);
+
+	// Display
+	bool update_texture();
+	Ref<Texture2DArray> get_texture() const { return texture; }
+	int get_write_column() const { return write_column; }
+	float get_scroll_offset() const;
+};
+
+#endif // SPECTROGRAM_WRITER_H
@@ -0,0 +1,224 @@
+/**************************************************************************/
+/*  spectrum_bands.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "spectrum_bands.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <cmath>
+
+SpectrumBands::SpectrumBands() {
+}
+
+SpectrumBands::~SpectrumBands() {
+}
+
+double SpectrumBands::_to_scale(Scale p_scale, double p_hz) {
+	switch (p_scale) {
+		case SCALE_LINEAR:
+			return p_hz;
+		case SCALE_LOG:
+		case SCALE_OCTAVE:
+			return log2(p_hz);
+		case SCALE_MEL:
+			return 2595.0 * log10(1.0 + p_hz / 700.0);
+		case SCALE_BARK:
+			// Traunmueller (1990)
+			return 26.81 * p_hz / (1960.0 + p_hz) - 0.53;
+	}
+	return p_hz;
+}
+
+double SpectrumBands::_from_scale(Scale p_scale, double p_value) {
+	switch (p_scale) {
+		case SCALE_LINEAR:
+			return p_value;
+		case SCALE_LOG:
+		case SCALE_OCTAVE:
+			return exp2(p_value);
+		case SCALE_MEL:
+			return 700.0 * (pow(10.0, p_value / 2595.0) - 1.0);
+		case SCALE_BARK:
+			return 1960.0 * (p_value + 0.53) / (26.28 - p_value);
+	}
+	return p_value;
+}
+
+Error SpectrumBands::setup(Scale p_scale, int p_band_count, int p_fft_size, float p_sample_rate, float p_min_hz, float p_max_hz) {
+	band_count = 0;
+	ERR_FAIL_COND_V(p_fft_size < 2, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_sample_rate <= 0.0f, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_min_hz < 0.0f || p_max_hz <= p_min_hz, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_scale != SCALE_OCTAVE && p_band_count < 1, ERR_INVALID_PARAMETER);
+
+	scale = p_scale;
+	bin_count = p_fft_size / 2 + 1;
+	double nyquist = p_sample_rate * 0.5;
+	double max_hz = MIN((double)p_max_hz, nyquist);
+	// Logarithmic scales can't reach 0 Hz; start them at the first bin
+	double min_hz = (scale == SCALE_LOG || scale == SCALE_OCTAVE) ? MAX((double)p_min_hz, p_sample_rate / (double)p_fft_size) : p_min_hz;
+	ERR_FAIL_COND_V(max_hz <= min_hz, ERR_INVALID_PARAMETER);
+
+	// Band b is a triangle from edges[b] through edges[b + 1] (peak) to edges[b + 2]
+	std::vector<double> edges;
+	if (scale == SCALE_OCTAVE) {
+		// 1/N-octave centers on the ISO grid (1 kHz * 2^(k/N))
+		double step = 1.0 / octave_fraction;
+		double first = floor(log2(min_hz / 1000.0) / step) * step;
+		for (double k = first; 1000.0 * exp2(k - step) <= max_hz; k += step) {
+			edges.push_back(1000.0 * exp2(k));
+		}
+	} else {
+		double lo = _to_scale(scale, min_hz);
+		double hi = _to_scale(scale, max_hz);
+		for (int i = 0; i < p_band_count + 2; i++) {
+			edges.push_back(_from_scale(scale, lo + (hi - lo) * i / (p_band_count + 1)));
+		}
+	}
+	ERR_FAIL_COND_V_MSG(edges.size() < 3, ERR_INVALID_PARAMETER, "Frequency range is too narrow for any band.");
+
+	int count = (int)edges.size() - 2;
+	double bins_per_hz = p_fft_size / (double)p_sample_rate;
+
+	band_first_bin.assign(count, 0);
+	band_length.assign(count, 0);
+	band_offset.assign(count, 0);
+	center_frequencies.assign(count, 0.0f);
+	weights.clear();
+
+	for (int b = 0; b < count; b++) {
+		double lo = edges[b] * bins_per_hz;
+		double center = edges[b + 1] * bins_per_hz;
+		double hi = edges[b + 2] * bins_per_hz;
+
+		int first = MAX((int)ceil(lo), 0);
+		int last = MIN((int)floor(hi), bin_count - 1);
+
+		band_offset[b] = (int)weights.size();
+		center_frequencies[b] = (float)edges[b + 1];
+
+		double sum = 0.0;
+		for (int k = first; k <= last; k++) {
+			double w = (k <= center) ? (k - lo) / MAX(center - lo, 1e-9) : (hi - k) / MAX(hi - center, 1e-9);
+			weights.push_back((float)w);
+			sum += w;
+		}
+
+		// Bands narrower than one bin (low end of log scales) take the nearest bin instead of going dark
+		if (sum <= 0.0) {
+			weights.resize(band_offset[b]);
+			first = CLAMP((int)llround(center), 0, bin_count - 1);
+			last = first;
+			weights.push_back(1.0f);
+			sum = 1.0;
+		}
+
+		band_first_bin[b] = first;
+		band_length[b] = last - first + 1;
+
+		if (normalize) {
+			for (int k = 0; k < band_length[b]; k++) {
+				weights[band_offset[b] + k] /= (float)sum;
+			}
+		}
+	}
+
+	band_count = count;
+	return OK;
+}
+
+void SpectrumBands::set_octave_fraction(int p_fraction) {
+	octave_fraction = CLAMP(p_fraction, 1, 48);
+}
+
+void SpectrumBands::set_normalize(bool p_normalize) {
+	normalize = p_normalize;
+}
+
+float SpectrumBands::get_band_center_frequency(int p_band) const {
+	ERR_FAIL_INDEX_V(p_band, band_count, 0.0f);
+	return center_frequencies[p_band];
+}
+
+PackedFloat32Array SpectrumBands::get_band_center_frequencies() const {
+	PackedFloat32Array result;
+	result.resize(band_count);
+	float *result_ptr = result.ptrw();
+	for (int b = 0; b < band_count; b++) {
+		result_ptr[b] = center_frequencies[b];
+	}
+	return result;
+}
+
+void SpectrumBands::apply_ptr(const float *p_spectrum, float *p_output) const {
+	const float *w = weights.data();
+	for (int b = 0; b < band_count; b++) {
+		const float *bins = p_spectrum + band_first_bin[b];
+		const float *band_weights = w + band_offset[b];
+		int length = band_length[b];
+
+		float sum = 0.0f;
+		for (int k = 0; k < length; k++) {
+			sum += bins[k] * band_weights[k];
+		}
+		p_output[b] = sum;
+	}
+}
+
+void SpectrumBands::apply(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(p_spectrum.is_null());
+	ERR_FAIL_COND(p_output.is_null());
+	ERR_FAIL_COND(p_spectrum->get_size() != bin_count);
+
+	p_output->resize(band_count);
+	apply_ptr(p_spectrum->get_buffer_ptr(), p_output->get_buffer_ptr());
+}
+
+PackedFloat32Array SpectrumBands::apply_array(const PackedFloat32Array &p_spectrum) {
+	PackedFloat32Array result;
+	ERR_FAIL_COND_V(!is_valid(), result);
+	ERR_FAIL_COND_V(p_spectrum.size() != bin_count, result);
+
+	result.resize(band_count);
+	apply_ptr(p_spectrum.ptr(), result.ptrw());
+	return result;
+}
+
+void SpectrumBands::_bind_methods() {
+	// Setup
+	ClassDB::bind_method(D_METHOD("setup", "scale", "band_count", "fft_size", "sample_rate", "min_hz", "max_hz"), &SpectrumBands::setup, DEFVAL(20.0f), DEFVAL(20000.0f));
+	ClassDB::bind_method(D_METHOD("is_valid"), &SpectrumBands::is_valid);
+
+	ClassDB::bind_method(D_METHOD("set_octave_fraction", "fraction"), &SpectrumBands::set_octave_fraction);
+	ClassDB::bind_method(D_METHOD("get_octave_fraction"), &SpectrumBands::get_octave_fraction);
+	ClassDB::bind_method(D_METHOD("set_normalize", "normalize"), &SpectrumBands::set_normalize);
+	ClassDB::bind_method(D_METHOD("is_normalize"), &SpectrumBands::is_normalize);
+
+	ClassDB::bind_method(D_METHOD("get_scale"), &SpectrumBands::get_scale);
+	ClassDB::bind_method(D_METHOD("get_band_count"), &SpectrumBands::get_band_count);
+	ClassDB::bind_method(D_METHOD("get_bin_count"), &SpectrumBands::get_bin_count);
+	ClassDB::bind_method(D_METHOD("get_band_center_frequency", "band"), &SpectrumBands::get_band_center_frequency);
+	ClassDB::bind_method(D_METHOD("get_band_center_frequencies"), &SpectrumBands::get_band_center_frequencies);
+
+	// Processing
+	ClassDB::bind_method(D_METHOD("apply", "spectrum", "output"), &SpectrumBands::apply);
+	ClassDB::bind_method(D_METHOD("apply_array", "spectrum"), &SpectrumBands::apply_array);
+
+	// Enums
+	BIND_ENUM_CONSTANT(SCALE_LINEAR);
+	BIND_ENUM_CONSTANT(SCALE_LOG);
+	BIND_ENUM_CONSTANT(SCALE_OCTAVE);
+	BIND_ENUM_CONSTANT(SCALE_MEL);
+	BIND_ENUM_CONSTANT(SCALE_BARK);
+
+	// Properties
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "octave_fraction", PROPERTY_HINT_RANGE, "1,48,1"), "set_octave_fraction", "get_octave_fraction");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "normalize"), "set_normalize", "is_normalize");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "scale", PROPERTY_HINT_ENUM, "Linear,Log,Octave,Mel,Bark"), "", "get_scale");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "band_count"), "", "get_band_count");
+}
@@ -0,0 +1,86 @@
+/**************************************************************************/
+/*  spectrum_bands.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef SPECTRUM_BANDS_H
+#define SPECTRUM_BANDS_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+#include "fft_buffer.h"
+
+#include <vector>
+
+using namespace godot;
+
+// Collapses linear FFT bins into perceptual bands with a precomputed sparse triangular weight matrix.
+// Each band only stores the contiguous run of bins it touches, so apply() is one pass over the weights.
+class SpectrumBands : public RefCounted {
+	GDCLASS(SpectrumBands, RefCounted);
+
+public:
+	enum Scale {
+		SCALE_LINEAR = 0,
+		SCALE_LOG = 1,
+		SCALE_OCTAVE = 2,
+		SCALE_MEL = 3,
+		SCALE_BARK = 4
+	};
+
+private:
+	Scale scale = SCALE_LOG;
+	int band_count = 0;
+	int bin_count = 0;
+	int octave_fraction = 3;
+	bool normalize = true;
+
+	// Sparse rows: band b covers bins [band_first_bin[b], band_first_bin[b] + band_length[b])
+	// using weights[band_offset[b] ...]
+	std::vector<int> band_first_bin;
+	std::vector<int> band_length;
+	std::vector<int> band_offset;
+	std::vector<float> weights;
+	std::vector<float> center_frequencies;
+
+	static double _to_scale(Scale p_scale, double p_hz);
+	static double _from_scale(Scale p_scale, double p_value);
+
+protected:
+	static void _bind_methods();
+
+public:
+	SpectrumBands();
+	~SpectrumBands();
+
+	// Setup (SCALE_OCTAVE ignores band_count and places octave_fraction bands per octave)
+	Error setup(Scale p_scale, int p_band_count, int p_fft_size, float p_sample_rate, float p_min_hz = 20.0f, float p_max_hz = 20000.0f);
+	bool is_valid() const { return band_count > 0; }
+
+	void set_octave_fraction(int p_fraction);
+	int get_octave_fraction() const { return octave_fraction; }
+
+	void set_normalize(bool p_normalize);
+	bool is_normalize() const { return normalize; }
+
+	Scale get_scale() const { return scale; }
+	int get_band_count() const { return band_count; }
+	int get_bin_count() const { return bin_count; }
+	float get_band_center_frequency(int p_band) const;
+	PackedFloat32Array get_band_center_frequencies() const;
+
+	// Apply to magnitude or power spectra (fft_size / 2 + 1 floats)
+	void apply(const Ref<FFTBuffer> &p_spectrum, const Ref<FFTBuffer> &p_output);
+	PackedFloat32Array apply_array(const PackedFloat32Array &p_spectrum);
+
+	// Direct access (for native callers)
+	void apply_ptr(const float *p_spectrum, float *p_output) const;
+};
+
+VARIANT_ENUM_CAST(SpectrumBands::Scale);
+
+#endif // SPECTRUM_BANDS_H
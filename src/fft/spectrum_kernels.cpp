@@ -0,0 +1,242 @@
+/**************************************************************************/
+/*  spectrum_kernels.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "spectrum_kernels.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPECTRUM_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define SPECTRUM_KERNELS_AVX
+#include <immintrin.h>
+#endif
+
+// 10 * log10(2), turns log2(power) into dB
+static const float DB_PER_LOG2 = 3.0102999566f;
+// Keeps log2 finite for silent bins; well below any useful floor
+static const float MIN_POWER = 1e-30f;
+
+static const float HALF_PI = 1.5707963268f;
+static const float PI = 3.1415926536f;
+
+// Scalar reference versions, also used for the tails of the vector loops
+
+static inline float _fast_log2(float p_value) {
+	// Split into exponent and mantissa in [1, 2), then a cubic fit of log2 on the mantissa
+	uint32_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	float exponent = (float)((int)((bits >> 23) & 0xFF) - 127);
+	bits = (bits & 0x007FFFFF) | 0x3F800000;
+	float m;
+	memcpy(&m, &bits, sizeof(m));
+	float poly = ((0.15824871f * m - 1.05187502f) * m + 3.04788415f) * m - 2.15419173f;
+	return exponent + poly;
+}
+
+static inline float _fast_atan2(float p_y, float p_x) {
+	float ax = fabsf(p_x);
+	float ay = fabsf(p_y);
+	float mx = ax > ay ? ax : ay;
+	float mn = ax > ay ? ay : ax;
+	float a = mn / (mx > 1e-30f ? mx : 1e-30f);
+	float s = a * a;
+	float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+	if (ay > ax) {
+		r = HALF_PI - r;
+	}
+	if (p_x < 0.0f) {
+		r = PI - r;
+	}
+	return p_y < 0.0f ? -r : r;
+}
+
+static inline float _process_scalar(SpectrumKernels::Kind p_kind, float p_re, float p_im, float p_floor_db) {
+	float power = p_re * p_re + p_im * p_im;
+	switch (p_kind) {
+		case SpectrumKernels::KIND_MAGNITUDE:
+			return sqrtf(power);
+		case SpectrumKernels::KIND_POWER:
+			return power;
+		case SpectrumKernels::KIND_DB: {
+			float db = DB_PER_LOG2 * _fast_log2(power > MIN_POWER ? power : MIN_POWER);
+			return db > p_floor_db ? db : p_floor_db;
+		}
+		case SpectrumKernels::KIND_PHASE:
+			return _fast_atan2(p_im, p_re);
+	}
+	return 0.0f;
+}
+
+#ifdef SPECTRUM_KERNELS_SSE2
+
+static inline __m128 _log2_sse(__m128 p_value) {
+	__m128i bits = _mm_castps_si128(p_value);
+	__m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+	__m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+	__m128 poly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.15824871f), m), _mm_set1_ps(-1.05187502f));
+	poly = _mm_add_ps(_mm_mul_ps(poly, m), _mm_set1_ps(3.04788415f));
+	poly = _mm_add_ps(_mm_mul_ps(poly, m), _mm_set1_ps(-2.15419173f));
+	return _mm_add_ps(exponent, poly);
+}
+
+static inline __m128 _select_sse(__m128 p_mask, __m128 p_a, __m128 p_b) {
+	return _mm_or_ps(_mm_and_ps(p_mask, p_a), _mm_andnot_ps(p_mask, p_b));
+}
+
+static inline __m128 _atan2_sse(__m128 p_y, __m128 p_x) {
+	const __m128 sign_mask = _mm_set1_ps(-0.0f);
+	__m128 ax = _mm_andnot_ps(sign_mask, p_x);
+	__m128 ay = _mm_andnot_ps(sign_mask, p_y);
+	__m128 mx = _mm_max_ps(ax, ay);
+	__m128 mn = _mm_min_ps(ax, ay);
+	__m128 a = _mm_div_ps(mn, _mm_max_ps(mx, _mm_set1_ps(1e-30f)));
+	__m128 s = _mm_mul_ps(a, a);
+	__m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.0464964749f), s), _mm_set1_ps(0.15931422f));
+	r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.327622764f));
+	r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r, s), a), a);
+	r = _select_sse(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(HALF_PI), r), r);
+	r = _select_sse(_mm_cmplt_ps(p_x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(PI), r), r);
+	return _mm_or_ps(r, _mm_and_ps(p_y, sign_mask)); // Copy the sign of y
+}
+
+template <SpectrumKernels::Kind KIND>
+static int _process_sse(const float *p_pairs, float *p_output, int p_count, float p_floor_db) {
+	const __m128 floor_db = _mm_set1_ps(p_floor_db);
+	int i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		// Deinterleave four [re, im] pairs
+		__m128 a = _mm_loadu_ps(p_pairs + i * 2);
+		__m128 b = _mm_loadu_ps(p_pairs + i * 2 + 4);
+		__m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+		__m128 result;
+		if (KIND == SpectrumKernels::KIND_PHASE) {
+			result = _atan2_sse(im, re);
+		} else {
+			__m128 power = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+			if (KIND == SpectrumKernels::KIND_MAGNITUDE) {
+				result = _mm_sqrt_ps(power);
+			} else if (KIND == SpectrumKernels::KIND_POWER) {
+				result = power;
+			} else {
+				power = _mm_max_ps(power, _mm_set1_ps(MIN_POWER));
+				result = _mm_max_ps(_mm_mul_ps(_mm_set1_ps(DB_PER_LOG2), _log2_sse(power)), floor_db);
+			}
+		}
+		_mm_storeu_ps(p_output + i, result);
+	}
+	return i;
+}
+
+#endif // SPECTRUM_KERNELS_SSE2
+
+#ifdef SPECTRUM_KERNELS_AVX
+
+template <SpectrumKernels::Kind KIND>
+static int _process_avx(const float *p_pairs, float *p_output, int p_count) {
+	int i = 0;
+	for (; i + 8 <= p_count; i += 8) {
+		// Regroup 128-bit halves first so the in-lane shuffles below come out in bin order
+		__m256 a = _mm256_loadu_ps(p_pairs + i * 2);
+		__m256 b = _mm256_loadu_ps(p_pairs + i * 2 + 8);
+		__m256 lo = _mm256_permute2f128_ps(a, b, 0x20); // pairs 0-1, 4-5
+		__m256 hi = _mm256_permute2f128_ps(a, b, 0x31); // pairs 2-3, 6-7
+		__m256 re = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+		__m256 im = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+		__m256 power = _mm256_add_ps(_mm256_mul_ps(re, re), _mm256_mul_ps(im, im));
+
+		__m256 result = (KIND == SpectrumKernels::KIND_MAGNITUDE) ? _mm256_sqrt_ps(power) : power;
+		_mm256_storeu_ps(p_output + i, result);
+	}
+	return i;
+}
+
+#endif // SPECTRUM_KERNELS_AVX
+
+template <SpectrumKernels::Kind KIND>
+static void _process(const float *p_pairs, float *p_output, int p_count, float p_floor_db) {
+	int i = 0;
+#ifdef SPECTRUM_KERNELS_AVX
+	if (KIND == SpectrumKernels::KIND_MAGNITUDE || KIND == SpectrumKernels::KIND_POWER) {
+		i = _process_avx<KIND>(p_pairs, p_output, p_count);
+	}
+#endif
+#ifdef SPECTRUM_KERNELS_SSE2
+	i += _process_sse<KIND>(p_pairs + i * 2, p_output + i, p_count - i, p_floor_db);
+#endif
+	for (; i < p_count; i++) {
+		p_output[i] = _process_scalar(KIND, p_pairs[i * 2], p_pairs[i * 2 + 1], p_floor_db);
+	}
+}
+
+void SpectrumKernels::process_interleaved(Kind p_kind, const float *p_pairs, float *p_output, int p_count, float p_floor_db) {
+	switch (p_kind) {
+		case KIND_MAGNITUDE:
+			_process<KIND_MAGNITUDE>(p_pairs, p_output, p_count, p_floor_db);
+			break;
+		case KIND_POWER:
+			_process<KIND_POWER>(p_pairs, p_output, p_count, p_floor_db);
+			break;
+		case KIND_DB:
+			_process<KIND_DB>(p_pairs, p_output, p_count, p_floor_db);
+			break;
+		case KIND_PHASE:
+			_process<KIND_PHASE>(p_pairs, p_output, p_count, p_floor_db);
+			break;
+	}
+}
+
+void SpectrumKernels::process_ordered_real(Kind p_kind, const float *p_ordered, float *p_output, int p_fft_size, float p_floor_db) {
+	int half = p_fft_size / 2;
+
+	// DC and Nyquist are packed into the first pair and are purely real
+	p_output[0] = _process_scalar(p_kind, p_ordered[0], 0.0f, p_floor_db);
+	p_output[half] = _process_scalar(p_kind, p_ordered[1], 0.0f, p_floor_db);
+
+	// Bins 1 .. N/2-1 are already interleaved from index 2
+	process_interleaved(p_kind, p_ordered + 2, p_output + 1, half - 1, p_floor_db);
+}
+
+void SpectrumKernels::amplitude_to_db(const float *p_input, float *p_output, int p_count, float p_floor_db) {
+	// 20 * log10(a) == 10 * log10(a^2); work on the amplitude directly to avoid squaring tiny values
+	const float db_per_log2 = DB_PER_LOG2 * 2.0f;
+	const float min_amplitude = 1e-15f;
+	int i = 0;
+#ifdef SPECTRUM_KERNELS_SSE2
+	const __m128 factor = _mm_set1_ps(db_per_log2);
+	const __m128 floor_db = _mm_set1_ps(p_floor_db);
+	const __m128 min_value = _mm_set1_ps(min_amplitude);
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 amplitude = _mm_max_ps(_mm_loadu_ps(p_input + i), min_value);
+		_mm_storeu_ps(p_output + i, _mm_max_ps(_mm_mul_ps(factor, _log2_sse(amplitude)), floor_db));
+	}
+#endif
+	for (; i < p_count; i++) {
+		float db = db_per_log2 * _fast_log2(p_input[i] > min_amplitude ? p_input[i] : min_amplitude);
+		p_output[i] = db > p_floor_db ? db : p_floor_db;
+	}
+}
+
+void SpectrumKernels::scale(float *p_data, int p_count, float p_scale) {
+	int i = 0;
+#ifdef SPECTRUM_KERNELS_SSE2
+	const __m128 factor = _mm_set1_ps(p_scale);
+	for (; i + 4 <= p_count; i += 4) {
+		_mm_storeu_ps(p_data + i, _mm_mul_ps(_mm_loadu_ps(p_data + i), factor));
+	}
+#endif
+	for (; i < p_count; i++) {
+		p_data[i] *= p_scale;
+	}
+}
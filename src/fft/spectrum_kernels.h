@@ -0,0 +1,42 @@
+/**************************************************************************/
+/*  spectrum_kernels.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef SPECTRUM_KERNELS_H
+#define SPECTRUM_KERNELS_H
+
+// Vectorized per-bin kernels over complex spectra (SSE2 on x86, AVX when the build enables it,
+// scalar elsewhere). Inputs are [re, im] float pairs; outputs are one float per bin and may not alias the input.
+class SpectrumKernels {
+public:
+	enum Kind {
+		KIND_MAGNITUDE, // |z|
+		KIND_POWER, // |z|^2
+		KIND_DB, // 10 * log10(|z|^2) within ~0.004 dB, clamped to floor_db
+		KIND_PHASE, // atan2(im, re) from a 7th-order polynomial, within 2.1e-4 rad
+	};
+
+	// p_count complex pairs -> p_count floats
+	static void process_interleaved(Kind p_kind, const float *p_pairs, float *p_output, int p_count, float p_floor_db = -120.0f);
+
+	// pffft ordered real spectrum ([DC, Nyquist, Re(1), Im(1), ...], p_fft_size floats) -> p_fft_size / 2 + 1 floats
+	static void process_ordered_real(Kind p_kind, const float *p_ordered, float *p_output, int p_fft_size, float p_floor_db = -120.0f);
+
+	// Convenience wrappers
+	static void magnitude(const float *p_pairs, float *p_output, int p_count) { process_interleaved(KIND_MAGNITUDE, p_pairs, p_output, p_count); }
+	static void power(const float *p_pairs, float *p_output, int p_count) { process_interleaved(KIND_POWER, p_pairs, p_output, p_count); }
+	static void decibels(const float *p_pairs, float *p_output, int p_count, float p_floor_db) { process_interleaved(KIND_DB, p_pairs, p_output, p_count, p_floor_db); }
+	static void phase(const float *p_pairs, float *p_output, int p_count) { process_interleaved(KIND_PHASE, p_pairs, p_output, p_count); }
+
+	// 20 * log10(amplitude) for already computed magnitudes, clamped to p_floor_db
+	static void amplitude_to_db(const float *p_input, float *p_output, int p_count, float p_floor_db);
+
+	// Multiplies p_count floats in place
+	static void scale(float *p_data, int p_count, float p_scale);
+};
+
+#endif // SPECTRUM_KERNELS_H
@@ -0,0 +1,319 @@
+/**************************************************************************/
+/*  stft_processor.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "stft_processor.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include "pffft.h"
+#include <cmath>
+#include <cstring>
+
+static float *_alloc_zeroed(int p_count) {
+	float *buffer = (float *)pffft_aligned_malloc(p_count * sizeof(float));
+	if (buffer != nullptr) {
+		memset(buffer, 0, p_count * sizeof(float));
+	}
+	return buffer;
+}
+
+static void _free_buffer(float *&r_buffer) {
+	if (r_buffer != nullptr) {
+		pffft_aligned_free(r_buffer);
+		r_buffer = nullptr;
+	}
+}
+
+STFTProcessor::STFTProcessor() {
+}
+
+STFTProcessor::~STFTProcessor() {
+	_cleanup();
+}
+
+void STFTProcessor::_cleanup() {
+	_free_buffer(window);
+	_free_buffer(frame_buffer);
+	_free_buffer(spectrum_buffer);
+	_free_buffer(input_ring);
+	_free_buffer(spectrum_queue);
+	_free_buffer(ola_buffer);
+	_free_buffer(output_fifo);
+
+	fft.unref();
+	frame_size = 0;
+	hop_size = 0;
+	queue_stride = 0;
+	output_capacity = 0;
+}
+
+void STFTProcessor::_build_window() {
+	// Periodic windows, so that overlapping frames sum to a constant at the usual hops
+	for (int i = 0; i < frame_size; i++) {
+		double x = Math_TAU * i / frame_size;
+		switch (window_type) {
+			case WINDOW_RECTANGULAR:
+				window[i] = 1.0f;
+				break;
+			case WINDOW_HANN:
+				window[i] = (float)(0.5 - 0.5 * cos(x));
+				break;
+			case WINDOW_HAMMING:
+				window[i] = (float)(0.54 - 0.46 * cos(x));
+				break;
+			case WINDOW_BLACKMAN:
+				window[i] = (float)(0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x));
+				break;
+		}
+	}
+
+	// The window is applied on analysis and again on synthesis, so normalize overlap-add by
+	// the summed squared window per hop (and by 1/N for the unscaled inverse transform).
+	double energy = 0.0;
+	double sum = 0.0;
+	for (int i = 0; i < frame_size; i++) {
+		energy += (double)window[i] * window[i];
+		sum += window[i];
+	}
+	window_sum = (float)sum;
+	ola_scale = (float)(hop_size / (energy * frame_size));
+}
+
+Error STFTProcessor::setup(int p_frame_size, int p_hop_size, WindowType p_window) {
+	_cleanup();
+
+	ERR_FAIL_COND_V(p_hop_size <= 0 || p_hop_size > p_frame_size, ERR_INVALID_PARAMETER);
+
+	fft.instantiate();
+	Error err = fft->setup_fft(p_frame_size, FFTProcessor::TRANSFORM_REAL);
+	if (err != OK) {
+		fft.unref();
+		return err;
+	}
+
+	frame_size = p_frame_size;
+	hop_size = p_hop_size;
+	window_type = p_window;
+	output_capacity = max_queued_frames * hop_size + frame_size;
+
+	queue_stride = frame_size + 4;
+	window = _alloc_zeroed(frame_size);
+	frame_buffer = _alloc_zeroed(frame_size);
+	spectrum_buffer = _alloc_zeroed(frame_size);
+	input_ring = _alloc_zeroed(frame_size);
+	spectrum_queue = _alloc_zeroed(queue_stride * max_queued_frames);
+	ola_buffer = _alloc_zeroed(frame_size);
+	output_fifo = _alloc_zeroed(output_capacity);
+
+	if (!window || !frame_buffer || !spectrum_buffer || !input_ring || !spectrum_queue || !ola_buffer || !output_fifo) {
+		_cleanup();
+		ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+	}
+
+	_build_window();
+	reset();
+
+	return OK;
+}
+
+void STFTProcessor::reset() {
+	if (!is_valid()) {
+		return;
+	}
+
+	memset(input_ring, 0, frame_size * sizeof(float));
+	memset(ola_buffer, 0, frame_size * sizeof(float));
+	input_write_pos = 0;
+	samples_until_hop = hop_size;
+	queue_read = 0;
+	queue_count = 0;
+	ola_pos = 0;
+	output_read = 0;
+	output_count = 0;
+}
+
+void STFTProcessor::set_max_queued_frames(int p_frames) {
+	ERR_FAIL_COND(p_frames < 1);
+	max_queued_frames = p_frames;
+
+	// Queues are sized at setup, so rebuild with the current configuration
+	if (is_valid()) {
+		setup(frame_size, hop_size, window_type);
+	}
+}
+
+void STFTProcessor::_emit_frame() {
+	// Unroll the ring (oldest sample first) and apply the window in the same pass
+	int tail = frame_size - input_write_pos;
+	const float *oldest = input_ring + input_write_pos;
+	for (int i = 0; i < tail; i++) {
+		frame_buffer[i] = oldest[i] * window[i];
+	}
+	const float *window_rest = window + tail;
+	for (int i = 0; i < input_write_pos; i++) {
+		frame_buffer[tail + i] = input_ring[i] * window_rest[i];
+	}
+
+	// Drop the oldest spectrum when nobody is draining the queue
+	if (queue_count == max_queued_frames) {
+		queue_read = (queue_read + 1) % max_queued_frames;
+		queue_count--;
+	}
+
+	int slot = (queue_read + queue_count) % max_queued_frames;
+	float *spectrum = spectrum_queue + slot * queue_stride;
+	fft->transform_ordered(frame_buffer, spectrum, FFTProcessor::FORWARD);
+
+	// Unpack Nyquist into the interleaved [re, im] layout used by FFTProcessor
+	spectrum[frame_size] = spectrum[1];
+	spectrum[frame_size + 1] = 0.0f;
+	spectrum[1] = 0.0f;
+
+	queue_count++;
+}
+
+int STFTProcessor::push_samples_ptr(const float *p_samples, int p_count) {
+	ERR_FAIL_COND_V(!is_valid(), 0);
+
+	int frames = 0;
+	while (p_count > 0) {
+		// Copy up to the next hop boundary or the end of the ring, whichever comes first
+		int chunk = MIN(p_count, MIN(samples_until_hop, frame_size - input_write_pos));
+		memcpy(input_ring + input_write_pos, p_samples, chunk * sizeof(float));
+
+		p_samples += chunk;
+		p_count -= chunk;
+		input_write_pos = (input_write_pos + chunk) % frame_size;
+		samples_until_hop -= chunk;
+
+		if (samples_until_hop == 0) {
+			_emit_frame();
+			samples_until_hop = hop_size;
+			frames++;
+		}
+	}
+
+	return frames;
+}
+
+int STFTProcessor::push_samples(const PackedFloat32Array &p_samples) {
+	return push_samples_ptr(p_samples.ptr(), p_samples.size());
+}
+
+bool STFTProcessor::pop_spectrum(const Ref<FFTBuffer> &p_output) {
+	ERR_FAIL_COND_V(p_output.is_null(), false);
+	if (queue_count == 0) {
+		return false;
+	}
+
+	int slot_size = frame_size + 2;
+	p_output->resize(slot_size);
+	memcpy(p_output->get_buffer_ptr(), spectrum_queue + queue_read * queue_stride, slot_size * sizeof(float));
+
+	queue_read = (queue_read + 1) % max_queued_frames;
+	queue_count--;
+	return true;
+}
+
+void STFTProcessor::push_spectrum_ptr(const float *p_spectrum) {
+	ERR_FAIL_COND(!is_valid());
+
+	// Repack to pffft's ordered format and transform back
+	memcpy(spectrum_buffer, p_spectrum, frame_size * sizeof(float));
+	spectrum_buffer[1] = p_spectrum[frame_size];
+	fft->transform_ordered(spectrum_buffer, frame_buffer, FFTProcessor::INVERSE);
+
+	// Synthesis window + normalization fused into the overlap-add
+	int tail = frame_size - ola_pos;
+	float *ola_oldest = ola_buffer + ola_pos;
+	for (int i = 0; i < tail; i++) {
+		ola_oldest[i] += frame_buffer[i] * window[i] * ola_scale;
+	}
+	for (int i = 0; i < ola_pos; i++) {
+		ola_buffer[i] += frame_buffer[tail + i] * window[tail + i] * ola_scale;
+	}
+
+	// The oldest hop is now complete; move it to the output FIFO and clear it for reuse
+	for (int i = 0; i < hop_size; i++) {
+		if (output_count == output_capacity) {
+			output_read = (output_read + 1) % output_capacity;
+			output_count--;
+		}
+		int write = (output_read + output_count) % output_capacity;
+		output_fifo[write] = ola_buffer[ola_pos];
+		output_count++;
+
+		ola_buffer[ola_pos] = 0.0f;
+		ola_pos = (ola_pos + 1) % frame_size;
+	}
+}
+
+void STFTProcessor::push_spectrum(const Ref<FFTBuffer> &p_spectrum) {
+	ERR_FAIL_COND(p_spectrum.is_null());
+	ERR_FAIL_COND(!is_valid());
+	ERR_FAIL_COND(p_spectrum->get_size() != frame_size + 2);
+
+	push_spectrum_ptr(p_spectrum->get_buffer_ptr());
+}
+
+int STFTProcessor::pop_samples_ptr(float *p_output, int p_count) {
+	int count = MIN(p_count, output_count);
+	for (int i = 0; i < count; i++) {
+		p_output[i] = output_fifo[output_read];
+		output_read = (output_read + 1) % output_capacity;
+	}
+	output_count -= count;
+	return count;
+}
+
+PackedFloat32Array STFTProcessor::pop_samples(int p_count) {
+	PackedFloat32Array result;
+	ERR_FAIL_COND_V(p_count < 0, result);
+
+	int count = MIN(p_count, output_count);
+	if (count > 0) {
+		result.resize(count);
+		pop_samples_ptr(result.ptrw(), count);
+	}
+	return result;
+}
+
+void STFTProcessor::_bind_methods() {
+	// Setup
+	ClassDB::bind_method(D_METHOD("setup", "frame_size", "hop_size", "window"), &STFTProcessor::setup, DEFVAL(WINDOW_HANN));
+	ClassDB::bind_method(D_METHOD("is_valid"), &STFTProcessor::is_valid);
+	ClassDB::bind_method(D_METHOD("reset"), &STFTProcessor::reset);
+	ClassDB::bind_method(D_METHOD("get_frame_size"), &STFTProcessor::get_frame_size);
+	ClassDB::bind_method(D_METHOD("get_hop_size"), &STFTProcessor::get_hop_size);
+	ClassDB::bind_method(D_METHOD("get_window_type"), &STFTProcessor::get_window_type);
+	ClassDB::bind_method(D_METHOD("get_spectrum_size"), &STFTProcessor::get_spectrum_size);
+	ClassDB::bind_method(D_METHOD("get_window_sum"), &STFTProcessor::get_window_sum);
+	ClassDB::bind_method(D_METHOD("set_max_queued_frames", "frames"), &STFTProcessor::set_max_queued_frames);
+	ClassDB::bind_method(D_METHOD("get_max_queued_frames"), &STFTProcessor::get_max_queued_frames);
+
+	// Analysis
+	ClassDB::bind_method(D_METHOD("push_samples", "samples"), &STFTProcessor::push_samples);
+	ClassDB::bind_method(D_METHOD("get_available_frames"), &STFTProcessor::get_available_frames);
+	ClassDB::bind_method(D_METHOD("pop_spectrum", "output"), &STFTProcessor::pop_spectrum);
+
+	// Resynthesis
+	ClassDB::bind_method(D_METHOD("push_spectrum", "spectrum"), &STFTProcessor::push_spectrum);
+	ClassDB::bind_method(D_METHOD("get_available_samples"), &STFTProcessor::get_available_samples);
+	ClassDB::bind_method(D_METHOD("pop_samples", "count"), &STFTProcessor::pop_samples);
+
+	// Enums
+	BIND_ENUM_CONSTANT(WINDOW_RECTANGULAR);
+	BIND_ENUM_CONSTANT(WINDOW_HANN);
+	BIND_ENUM_CONSTANT(WINDOW_HAMMING);
+	BIND_ENUM_CONSTANT(WINDOW_BLACKMAN);
+
+	// Properties
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "frame_size"), "", "get_frame_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "hop_size"), "", "get_hop_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "window_type", PROPERTY_HINT_ENUM, "Rectangular,Hann,Hamming,Blackman"), "", "get_window_type");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_queued_frames", PROPERTY_HINT_RANGE, "1,256,1"), "set_max_queued_frames", "get_max_queued_frames");
+}
@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*  stft_processor.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef STFT_PROCESSOR_H
+#define STFT_PROCESSOR_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+#include "fft_buffer.h"
+#include "fft_processor.h"
+
+using namespace godot;
+
+class STFTProcessor : public RefCounted {
+	GDCLASS(STFTProcessor, RefCounted);
+
+public:
+	enum WindowType {
+		WINDOW_RECTANGULAR = 0,
+		WINDOW_HANN = 1,
+		WINDOW_HAMMING = 2,
+		WINDOW_BLACKMAN = 3
+	};
+
+private:
+	Ref<FFTProcessor> fft;
+	int frame_size = 0;
+	int hop_size = 0;
+	int max_queued_frames = 16;
+	WindowType window_type = WINDOW_HANN;
+
+	float *window = nullptr;
+	float *frame_buffer = nullptr; // Windowed frame / inverse transform output, aligned for pffft
+	float *spectrum_buffer = nullptr; // Ordered spectrum staging for the inverse direction
+
+	// Analysis: ring of the last frame_size samples plus a queue of interleaved spectra
+	float *input_ring = nullptr;
+	int input_write_pos = 0;
+	int samples_until_hop = 0;
+
+	float *spectrum_queue = nullptr; // max_queued_frames slots of (frame_size + 2) floats
+	int queue_stride = 0; // Slot stride, padded so every slot stays SIMD-aligned
+	int queue_read = 0;
+	int queue_count = 0;
+
+	// Synthesis: overlap-add accumulator plus a FIFO of finished samples
+	float *ola_buffer = nullptr;
+	int ola_pos = 0;
+	float ola_scale = 1.0f;
+	float window_sum = 0.0f;
+
+	float *output_fifo = nullptr;
+	int output_capacity = 0;
+	int output_read = 0;
+	int output_count = 0;
+
+	void _cleanup();
+	void _build_window();
+	void _emit_frame();
+
+protected:
+	static void _bind_methods();
+
+public:
+	STFTProcessor();
+	~STFTProcessor();
+
+	// Setup
+	Error setup(int p_frame_size, int p_hop_size, WindowType p_window = WINDOW_HANN);
+	bool is_valid() const { return fft.is_valid() && fft->is_valid(); }
+	void reset();
+
+	int get_frame_size() const { return frame_size; }
+	int get_hop_size() const { return hop_size; }
+	WindowType get_window_type() const { return window_type; }
+	int get_spectrum_size() const { return frame_size / 2 + 1; }
+	float get_window_sum() const { return window_sum; } // Coherent gain * frame_size, for amplitude normalization
+
+	void set_max_queued_frames(int p_frames);
+	int get_max_queued_frames() const { return max_queued_frames; }
+
+	// Analysis
+	int push_samples(const PackedFloat32Array &p_samples);
+	int push_samples_ptr(const float *p_samples, int p_count);
+	int get_available_frames() const { return queue_count; }
+	bool pop_spectrum(const Ref<FFTBuffer> &p_output);
+
+	// Resynthesis (overlap-add)
+	void push_spectrum(const Ref<FFTBuffer> &p_spectrum);
+	void push_spectrum_ptr(const float *p_spectrum);
+	int get_available_samples() const { return output_count; }
+	PackedFloat32Array pop_samples(int p_count);
+	int pop_samples_ptr(float *p_output, int p_count);
+};
+
+VARIANT_ENUM_CAST(STFTProcessor::WindowType);
+
+#endif // STFT_PROCESSOR_H
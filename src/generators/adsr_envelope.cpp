@@ -0,0 +1,135 @@
+/**************************************************************************/
+/*  adsr_envelope.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "adsr_envelope.h"
+#include <cmath>
+
+// Exponential segments aim this far past their end level (as a fraction of the full swing).
+// A large ratio gives a nearly linear attack; a small one gives decays and releases the
+// familiar analog shape that still ends in finite time.
+static const float ATTACK_RATIO = 0.3f;
+static const float DECAY_RATIO = 0.001f;
+
+ADSREnvelope::Stage ADSREnvelope::next_stage(Stage p_stage) {
+	switch (p_stage) {
+		case STAGE_ATTACK:
+			return STAGE_DECAY;
+		case STAGE_DECAY:
+			return STAGE_SUSTAIN;
+		case STAGE_SUSTAIN:
+			return STAGE_SUSTAIN;
+		case STAGE_RELEASE:
+		case STAGE_IDLE:
+			return STAGE_IDLE;
+	}
+	return STAGE_IDLE;
+}
+
+float ADSREnvelope::_end_level(Stage p_stage, float p_peak, const Settings &p_settings) {
+	switch (p_stage) {
+		case STAGE_ATTACK:
+			return p_peak;
+		case STAGE_DECAY:
+		case STAGE_SUSTAIN:
+			return p_peak * p_settings.sustain;
+		case STAGE_RELEASE:
+		case STAGE_IDLE:
+			return 0.0f;
+	}
+	return 0.0f;
+}
+
+ADSREnvelope::Segment ADSREnvelope::_make_segment(Stage p_stage, float p_value, float p_peak, const Settings &p_settings, float p_sample_rate) {
+	Segment segment;
+	float end = _end_level(p_stage, p_peak, p_settings);
+	segment.lo = fminf(p_value, end);
+	segment.hi = fmaxf(p_value, end);
+	segment.end = end;
+
+	// Nominal segment: full swing from start to end in time * rate samples.
+	// The release always swings from the current value, so it lasts its full time from any level.
+	// So does an attack that starts above its peak (a retrigger or a stolen voice at a lower
+	// velocity): it ramps down to the peak over the attack time instead of jumping there.
+	float start;
+	float time;
+	float ratio;
+	switch (p_stage) {
+		case STAGE_ATTACK:
+			start = p_value > end ? p_value : 0.0f;
+			time = p_settings.attack;
+			ratio = p_value > end ? DECAY_RATIO : ATTACK_RATIO;
+			break;
+		case STAGE_DECAY:
+			start = p_peak;
+			time = p_settings.decay;
+			ratio = DECAY_RATIO;
+			break;
+		case STAGE_RELEASE:
+			start = p_value;
+			time = p_settings.release;
+			ratio = DECAY_RATIO;
+			break;
+		default:
+			segment.length = -1;
+			return segment;
+	}
+
+	float samples = time * p_sample_rate;
+	float swing = end - start;
+	if (samples < 1.0f || swing == 0.0f || p_value == end) {
+		segment.length = 0;
+		return segment;
+	}
+
+	if (p_settings.curve == CURVE_LINEAR) {
+		float step = swing / samples;
+		segment.add = step;
+		segment.length = (int32_t)ceilf((end - p_value) / step);
+	} else {
+		// value[n] = target + (value[0] - target) * mul^n, with mul chosen so the full swing takes `samples`
+		float target = end + ratio * swing;
+		float mul = expf(logf(ratio / (1.0f + ratio)) / samples);
+		segment.mul = mul;
+		segment.add = (1.0f - mul) * target;
+
+		// Fraction of the distance to the target still left at the end; not in (0, 1] when the
+		// value is already past the end level, and the log would be NaN or positive
+		float remaining = (end - target) / (p_value - target);
+		segment.length = (remaining > 0.0f && remaining < 1.0f) ? (int32_t)ceilf(logf(remaining) / logf(mul)) : 0;
+	}
+
+	// Values outside the segment's range (e.g. above the peak after a velocity change) end right away
+	if (segment.length < 0) {
+		segment.length = 0;
+	}
+	return segment;
+}
+
+ADSREnvelope::Segment ADSREnvelope::enter(Stage &r_stage, float &r_value, float p_peak, const Settings &p_settings, float p_sample_rate) {
+	while (true) {
+		if (r_stage == STAGE_SUSTAIN && _end_level(r_stage, p_peak, p_settings) <= 0.0f) {
+			r_stage = STAGE_IDLE; // Sustaining silence: let renderers skip the voice
+		}
+		if (r_stage == STAGE_IDLE || r_stage == STAGE_SUSTAIN) {
+			// Holds until the next event
+			Segment hold;
+			r_value = _end_level(r_stage, p_peak, p_settings);
+			hold.lo = r_value;
+			hold.hi = r_value;
+			hold.end = r_value;
+			return hold;
+		}
+
+		Segment segment = _make_segment(r_stage, r_value, p_peak, p_settings, p_sample_rate);
+		if (segment.length > 0) {
+			return segment;
+		}
+		r_value = _end_level(r_stage, p_peak, p_settings);
+		r_stage = next_stage(r_stage);
+	}
+}
@@ -0,0 +1,63 @@
+/**************************************************************************/
+/*  adsr_envelope.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef ADSR_ENVELOPE_H
+#define ADSR_ENVELOPE_H
+
+#include <cstdint>
+
+// ADSR envelopes as a chain of segments in the form the voice kernels run per sample:
+// value = clamp(value * mul + add, lo, hi). Linear ramps have mul = 1; exponential ones are one-pole
+// curves aimed past their end level, so they reach it after a known number of samples and the clamp
+// lands them on it exactly. Segments are computed once when a stage starts (this is where the only
+// log/exp calls are); renderers split their block where a segment ends, so stage changes are sample-accurate.
+class ADSREnvelope {
+public:
+	enum Stage : uint8_t {
+		STAGE_IDLE, // Silent, renderers can skip the voice
+		STAGE_ATTACK,
+		STAGE_DECAY,
+		STAGE_SUSTAIN,
+		STAGE_RELEASE,
+	};
+
+	enum Curve {
+		CURVE_LINEAR,
+		CURVE_EXPONENTIAL,
+	};
+
+	struct Settings {
+		float attack = 0.005f; // Seconds from 0 to the peak
+		float decay = 0.1f; // Seconds from the peak to the sustain level
+		float sustain = 1.0f; // Fraction of the peak
+		float release = 0.05f; // Seconds from any level to 0
+		Curve curve = CURVE_LINEAR;
+	};
+
+	struct Segment {
+		float mul = 1.0f;
+		float add = 0.0f;
+		float lo = 0.0f;
+		float hi = 0.0f;
+		float end = 0.0f; // Exact value once length runs out; renderers continue from it, not from the rounded ramp
+		int32_t length = -1; // Samples until the next stage, -1 = until the next event
+	};
+
+	// Starts r_stage at r_value. Stages that would last zero samples (no time, or already at their
+	// end level) are passed through, so r_stage and r_value may change. p_peak is the attack target.
+	static Segment enter(Stage &r_stage, float &r_value, float p_peak, const Settings &p_settings, float p_sample_rate);
+
+	// Stage that follows p_stage when its segment runs out
+	static Stage next_stage(Stage p_stage);
+
+private:
+	static float _end_level(Stage p_stage, float p_peak, const Settings &p_settings);
+	static Segment _make_segment(Stage p_stage, float p_value, float p_peak, const Settings &p_settings, float p_sample_rate);
+};
+
+#endif // ADSR_ENVELOPE_H
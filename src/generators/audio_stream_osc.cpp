@@ -7,54 +7,99 @@
 /**************************************************************************/
 
 #include "audio_stream_osc.h"
+#include "osc_kernels.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <atomic>
 #include <cmath>
+#include <cstring>
+
+// Samples rendered per kernel call; the mono scratch lives on the stack
+static const int MIX_BLOCK_SIZE = 256;
+
+// Seeds the unison phase generator of each new playback
+static std::atomic<uint32_t> playback_seed{ 1 };
 
 // AudioStreamPlaybackOsc Implementation
 
 AudioStreamPlaybackOsc::AudioStreamPlaybackOsc() {
-	phase = 0.0;
+	phase = 0;
 	sample_rate = AudioServer::get_singleton()->get_mix_rate();
+	random_state = playback_seed.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B9u;
+	_randomize_unison_phases();
+	_reset_modulation();
 }
 
 AudioStreamPlaybackOsc::~AudioStreamPlaybackOsc() {
 }
 
 void AudioStreamPlaybackOsc::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("note_on", "velocity"), &AudioStreamPlaybackOsc::note_on, DEFVAL(1.0f));
+	ClassDB::bind_method(D_METHOD("note_off"), &AudioStreamPlaybackOsc::note_off);
 }
 
-void AudioStreamPlaybackOsc::set_stream(const Ref<AudioStreamOsc> &p_stream) {
+void AudioStreamPlaybackOsc::set_stream(const Ref<AudioStreamOsc> &p_stream, uint32_t p_voice) {
 	stream = p_stream;
-}
+	noise_voice = p_voice;
 
-float AudioStreamPlaybackOsc::generate_sample() {
-	if (stream.is_null()) {
-		return 0.0f;
+	AudioStreamOsc::Params params;
+	if (stream.is_valid() && stream->read_params(params)) {
+		_seed_noise(params.noise_seed);
 	}
+}
 
-	float sample = 0.0f;
-	float amplitude = stream->get_amplitude_linear();
-
-	switch (stream->get_waveform_type()) {
-		case AudioStreamOsc::WAVEFORM_SINE:
-			sample = amplitude * std::sin(2.0 * Math_PI * phase);
-			break;
+void AudioStreamPlaybackOsc::_randomize_unison_phases() {
+	// Copies starting in phase would sum into one loud, slowly beating tone
+	for (int i = 0; i < MAX_UNISON; i++) {
+		random_state ^= random_state << 13;
+		random_state ^= random_state >> 17;
+		random_state ^= random_state << 5;
+		unison_phase[i] = random_state;
+	}
+}
 
-		case AudioStreamOsc::WAVEFORM_SAW:
-			sample = amplitude * (2.0f * phase - 1.0f);
-			break;
+void AudioStreamPlaybackOsc::_seed_noise(int p_seed) {
+	noise_seed = p_seed;
+	OscKernels::seed_noise(noise_state, (uint32_t)p_seed ^ (noise_voice * 0x9E3779B9u));
+}
 
-		case AudioStreamOsc::WAVEFORM_SQUARE:
-			sample = amplitude * (phase < 0.5 ? 1.0f : -1.0f);
-			break;
+void AudioStreamPlaybackOsc::_reset_modulation() {
+	// LFOs restart at phase 0; the random ones get their own sequence per playback
+	for (int l = 0; l < MAX_LFOS; l++) {
+		lfos[l].reset(random_state + (uint32_t)l * 0x9E3779B9u);
 	}
+	control_remaining = 0;
+	modulation_to[AudioStreamOsc::MOD_PITCH] = 1.0f;
+	modulation_to[AudioStreamOsc::MOD_AMPLITUDE] = 1.0f;
+	modulation_to[AudioStreamOsc::MOD_PULSE_WIDTH] = 0.0f;
+	memcpy(modulation_from, modulation_to, sizeof(modulation_from));
+}
+
+void AudioStreamPlaybackOsc::note_on(float p_velocity) {
+	gate_velocity.store(CLAMP(p_velocity, 0.0f, 1.0f), std::memory_order_relaxed);
+	uint32_t count = (gate.load(std::memory_order_relaxed) >> 1) + 1;
+	gate.store((count << 1) | 1u, std::memory_order_release);
+}
 
-	return sample;
+void AudioStreamPlaybackOsc::note_off() {
+	gate.store(gate.load(std::memory_order_relaxed) & ~1u, std::memory_order_release);
 }
 
 void AudioStreamPlaybackOsc::_start(double p_from_pos) {
-	phase = 0.0;
+	phase = 0;
+	_randomize_unison_phases();
+	_reset_modulation();
+
+	// A note_on() sent just before play() has not been seen yet, so it still starts the envelope
+	envelope_stage = ADSREnvelope::STAGE_IDLE;
+	envelope_value = 0.0f;
+
+	// Start at the current amplitude instead of ramping up from the last note; noise restarts its sequence
+	AudioStreamOsc::Params params;
+	if (stream.is_valid() && stream->read_params(params)) {
+		amplitude_ramp.reset(params.amplitude_linear);
+		_seed_noise(params.noise_seed);
+	}
 }
 
 void AudioStreamPlaybackOsc::_stop() {
@@ -81,34 +126,280 @@ int AudioStreamPlaybackOsc::_mix(AudioFrame *p_buffer, float p_rate_scale, int p
 	if (stream.is_null()) {
 		// Fill with silence if no stream
 		for (int32_t i = 0; i < p_frames; i++) {
-            p_buffer[i].left = 0.0f;
-            p_buffer[i].right = 0.0f;
-        }
+			p_buffer[i].left = 0.0f;
+			p_buffer[i].right = 0.0f;
+		}
 		return p_frames;
 	}
 
-	float frequency = stream->get_frequency() * p_rate_scale;
-	double phase_increment = frequency / sample_rate;
-
-	for (int32_t i = 0; i < p_frames; i++) {
-		float sample = generate_sample();
-		
-		// Output same signal to both channels (mono to stereo)
-		p_buffer[i].left = sample;
-        p_buffer[i].right = sample;
+	// One consistent parameter snapshot per block
+	AudioStreamOsc::Params params;
+	if (stream->read_params(params)) {
+		shape = AudioStreamOsc::get_kernel_shape(params.waveform_type, params.band_limited);
+		noise = AudioStreamOsc::is_noise(params.waveform_type);
+		noise_color = AudioStreamOsc::get_noise_color(params.waveform_type);
+		if (params.noise_seed != noise_seed) {
+			_seed_noise(params.noise_seed);
+		}
+		frequency = params.frequency;
+		amplitude = params.amplitude_linear;
+		pulse_width = params.pulse_width;
+		unison_voices = params.unison_voices;
+		memcpy(unison_ratio, params.unison_ratio, sizeof(unison_ratio));
+		memcpy(unison_pan_left, params.unison_pan_left, sizeof(unison_pan_left));
+		memcpy(unison_pan_right, params.unison_pan_right, sizeof(unison_pan_right));
+		envelope_enabled = params.envelope_enabled;
+		envelope = params.envelope;
+		modulation_interval = params.modulation_interval;
+		memcpy(lfo_rate, params.lfo_rate, sizeof(lfo_rate));
+		memcpy(lfo_shape, params.lfo_shape, sizeof(lfo_shape));
+		routing = params.routing;
+		control_remaining = MIN(control_remaining, modulation_interval);
+	}
 
-		// Advance phase
-		phase += phase_increment;
-		
-		// Wrap phase to [0, 1)
-		if (phase >= 1.0) {
-			phase -= 1.0;
+	if (envelope_enabled) {
+		_process_gate();
+		if (envelope_stage == ADSREnvelope::STAGE_IDLE) {
+			// Nothing to render until the next note_on()
+			float amplitude_step;
+			amplitude_ramp.begin(amplitude, p_frames, amplitude_step);
+			for (int32_t i = 0; i < p_frames; i++) {
+				p_buffer[i].left = 0.0f;
+				p_buffer[i].right = 0.0f;
+			}
+			return p_frames;
 		}
 	}
 
+	double increment = frequency * p_rate_scale / sample_rate;
+
+	// Amplitude changes ramp over the whole block to avoid zipper noise
+	float amplitude_step;
+	float gain = amplitude_ramp.begin(amplitude, p_frames, amplitude_step);
+
+	if (routing.count == 0) {
+		_render(p_buffer, p_frames, increment, pulse_width, gain, amplitude_step);
+		return p_frames;
+	}
+
+	// Modulated: the matrix is evaluated at each control tick, and every destination moves
+	// linearly from one tick's value to the next. The block is rendered in spans between ticks.
+	int32_t offset = 0;
+	while (offset < p_frames) {
+		if (control_remaining <= 0) {
+			_tick_modulation(p_rate_scale);
+		}
+		int32_t span = MIN(control_remaining, p_frames - offset);
+
+		float start[MOD_DESTINATIONS];
+		float end[MOD_DESTINATIONS];
+		float t_start = 1.0f - (float)control_remaining / modulation_interval;
+		float t_end = 1.0f - (float)(control_remaining - span) / modulation_interval;
+		for (int d = 0; d < MOD_DESTINATIONS; d++) {
+			float delta = modulation_to[d] - modulation_from[d];
+			start[d] = modulation_from[d] + delta * t_start;
+			end[d] = modulation_from[d] + delta * t_end;
+		}
+
+		// A linear frequency ramp advances the phase exactly as far as its mean frequency does,
+		// so each span renders at the mean and the phase is right at every tick
+		double span_increment = increment * 0.5 * (start[AudioStreamOsc::MOD_PITCH] + end[AudioStreamOsc::MOD_PITCH]);
+		float width = CLAMP(pulse_width + 0.5f * (start[AudioStreamOsc::MOD_PULSE_WIDTH] + end[AudioStreamOsc::MOD_PULSE_WIDTH]), 0.01f, 0.99f);
+		float gain_start = (gain + offset * amplitude_step) * start[AudioStreamOsc::MOD_AMPLITUDE];
+		float gain_end = (gain + (offset + span) * amplitude_step) * end[AudioStreamOsc::MOD_AMPLITUDE];
+		_render(p_buffer + offset, span, span_increment, width, gain_start, (gain_end - gain_start) / span);
+
+		offset += span;
+		control_remaining -= span;
+	}
 	return p_frames;
 }
 
+void AudioStreamPlaybackOsc::_tick_modulation(float p_rate_scale) {
+	// Only LFOs with a route are advanced
+	float sources[MAX_LFOS];
+	float tick_length = modulation_interval * p_rate_scale / (float)sample_rate;
+	for (int s = 0; s < routing.source_count; s++) {
+		int l = routing.sources[s];
+		sources[l] = lfos[l].tick(lfo_shape[l], lfo_rate[l] * tick_length);
+	}
+
+	float values[MOD_DESTINATIONS];
+	ModMatrix::evaluate(routing, sources, values);
+
+	// Converted once per tick, so the audio loop only interpolates
+	memcpy(modulation_from, modulation_to, sizeof(modulation_from));
+	modulation_to[AudioStreamOsc::MOD_PITCH] = exp2f(CLAMP(values[AudioStreamOsc::MOD_PITCH], -48.0f, 48.0f) / 12.0f);
+	modulation_to[AudioStreamOsc::MOD_AMPLITUDE] = MAX(0.0f, 1.0f + values[AudioStreamOsc::MOD_AMPLITUDE]);
+	modulation_to[AudioStreamOsc::MOD_PULSE_WIDTH] = values[AudioStreamOsc::MOD_PULSE_WIDTH];
+	control_remaining = modulation_interval;
+}
+
+void AudioStreamPlaybackOsc::_render(AudioFrame *p_buffer, int p_frames, double p_increment, float p_pulse_width, float p_amplitude, float p_amplitude_step) {
+	// Detuned copies of noise would only be more noise, so unison does not apply to it
+	if (unison_voices > 1 && !noise) {
+		_mix_unison(p_buffer, p_frames, p_increment, p_pulse_width, p_amplitude, p_amplitude_step);
+		return;
+	}
+
+	OscKernels::State state;
+	state.phase = phase;
+	state.increment = OscKernels::phase_increment_64(p_increment);
+	state.pulse_width = p_pulse_width;
+	state.amplitude = p_amplitude;
+	state.amplitude_step = p_amplitude_step;
+
+	// Render mono, then duplicate to both channels
+	alignas(16) float mono[MIX_BLOCK_SIZE];
+	for (int32_t offset = 0; offset < p_frames; offset += MIX_BLOCK_SIZE) {
+		int32_t count = MIN(MIX_BLOCK_SIZE, p_frames - offset);
+		if (noise) {
+			OscKernels::render_noise(noise_color, mono, count, noise_state, state);
+		} else {
+			OscKernels::render(shape, mono, count, state);
+		}
+		if (envelope_enabled) {
+			_apply_envelope(mono, count);
+		}
+		OscKernels::splat_stereo(mono, (float *)(p_buffer + offset), count);
+	}
+
+	phase = state.phase;
+}
+
+void AudioStreamPlaybackOsc::_process_gate() {
+	uint32_t current = gate.load(std::memory_order_acquire);
+	if ((current >> 1) != (gate_seen >> 1)) {
+		// Retriggers start the attack from the current value, so there is no click
+		envelope_peak = gate_velocity.load(std::memory_order_relaxed);
+		_enter_envelope_stage(ADSREnvelope::STAGE_ATTACK);
+	}
+	if (!(current & 1u) && envelope_stage != ADSREnvelope::STAGE_RELEASE && envelope_stage != ADSREnvelope::STAGE_IDLE) {
+		_enter_envelope_stage(ADSREnvelope::STAGE_RELEASE);
+	}
+	gate_seen = current;
+}
+
+void AudioStreamPlaybackOsc::_enter_envelope_stage(ADSREnvelope::Stage p_stage) {
+	envelope_stage = p_stage;
+	envelope_segment = ADSREnvelope::enter(envelope_stage, envelope_value, envelope_peak, envelope, (float)sample_rate);
+}
+
+void AudioStreamPlaybackOsc::_load_envelope(OscKernels::VoiceGroup *r_groups, int p_group_count, int p_lanes) const {
+	// Every copy follows the same envelope; without one the lanes hold a constant 1
+	ADSREnvelope::Segment segment = envelope_segment;
+	float value = envelope_value;
+	if (!envelope_enabled) {
+		segment = ADSREnvelope::Segment();
+		segment.lo = 1.0f;
+		segment.hi = 1.0f;
+		value = 1.0f;
+	}
+
+	for (int g = 0; g < p_group_count; g++) {
+		OscKernels::VoiceGroup &group = r_groups[g];
+		for (int lane = 0; lane < OscKernels::GROUP_SIZE; lane++) {
+			bool used = g * OscKernels::GROUP_SIZE + lane < p_lanes;
+			group.gain[lane] = used ? value : 0.0f;
+			group.gain_mul[lane] = used ? segment.mul : 1.0f;
+			group.gain_step[lane] = used ? segment.add : 0.0f;
+			group.gain_min[lane] = used ? segment.lo : 0.0f;
+			group.gain_max[lane] = used ? segment.hi : 0.0f;
+		}
+	}
+}
+
+void AudioStreamPlaybackOsc::_apply_envelope(float *r_block, int p_count) {
+	// Split where the segment ends, so the next one starts on the exact sample
+	int32_t done = 0;
+	while (done < p_count) {
+		int32_t span = p_count - done;
+		bool segment_ends = envelope_segment.length > 0 && envelope_segment.length <= span;
+		if (segment_ends) {
+			span = envelope_segment.length;
+		}
+
+		OscKernels::apply_gain(r_block + done, span, envelope_value, envelope_segment.mul, envelope_segment.add, envelope_segment.lo, envelope_segment.hi);
+		done += span;
+
+		if (envelope_segment.length > 0) {
+			envelope_segment.length -= span;
+		}
+		if (segment_ends) {
+			envelope_value = envelope_segment.end;
+			_enter_envelope_stage(ADSREnvelope::next_stage(envelope_stage));
+		}
+	}
+}
+
+void AudioStreamPlaybackOsc::_mix_unison(AudioFrame *p_buffer, int p_frames, double p_increment, float p_pulse_width, float p_amplitude, float p_amplitude_step) {
+	float gain = p_amplitude;
+
+	// Detune and pan come from the block's snapshot
+	OscKernels::VoiceGroup groups[2];
+	int group_count = (unison_voices + OscKernels::GROUP_SIZE - 1) / OscKernels::GROUP_SIZE;
+	for (int g = 0; g < group_count; g++) {
+		OscKernels::VoiceGroup &group = groups[g];
+		for (int lane = 0; lane < OscKernels::GROUP_SIZE; lane++) {
+			int voice = g * OscKernels::GROUP_SIZE + lane;
+			bool used = voice < unison_voices;
+			group.phase[lane] = unison_phase[voice];
+			group.increment[lane] = used ? OscKernels::phase_increment(p_increment * unison_ratio[voice]) : 0;
+			group.pan_left[lane] = used ? unison_pan_left[voice] : 0.0f;
+			group.pan_right[lane] = used ? unison_pan_right[voice] : 0.0f;
+		}
+	}
+	_load_envelope(groups, group_count, unison_voices);
+
+	// Lanes carry the envelope; the amplitude ramp is applied to the summed block
+	alignas(16) float left[MIX_BLOCK_SIZE];
+	alignas(16) float right[MIX_BLOCK_SIZE];
+	for (int32_t offset = 0; offset < p_frames; offset += MIX_BLOCK_SIZE) {
+		int32_t count = MIN(MIX_BLOCK_SIZE, p_frames - offset);
+		for (int32_t i = 0; i < count; i++) {
+			left[i] = 0.0f;
+			right[i] = 0.0f;
+		}
+
+		// Split where the envelope segment ends, as in _apply_envelope()
+		int32_t done = 0;
+		while (done < count) {
+			int32_t span = count - done;
+			bool segment_ends = envelope_enabled && envelope_segment.length > 0 && envelope_segment.length <= span;
+			if (segment_ends) {
+				span = envelope_segment.length;
+			}
+
+			for (int g = 0; g < group_count; g++) {
+				int lanes = MIN(OscKernels::GROUP_SIZE, unison_voices - g * OscKernels::GROUP_SIZE);
+				OscKernels::render_voices_stereo(shape, groups[g], lanes, p_pulse_width, left + done, right + done, span);
+			}
+			done += span;
+
+			if (envelope_enabled && envelope_segment.length > 0) {
+				envelope_segment.length -= span;
+				envelope_value = groups[0].gain[0];
+			}
+			if (segment_ends) {
+				envelope_value = envelope_segment.end;
+				_enter_envelope_stage(ADSREnvelope::next_stage(envelope_stage));
+				_load_envelope(groups, group_count, unison_voices);
+			}
+		}
+
+		for (int32_t i = 0; i < count; i++) {
+			left[i] *= gain;
+			right[i] *= gain;
+			gain += p_amplitude_step;
+		}
+		OscKernels::interleave_stereo(left, right, (float *)(p_buffer + offset), count);
+	}
+
+	for (int voice = 0; voice < unison_voices; voice++) {
+		unison_phase[voice] = groups[voice / OscKernels::GROUP_SIZE].phase[voice % OscKernels::GROUP_SIZE];
+	}
+}
+
 void AudioStreamPlaybackOsc::_tag_used_streams() {
 	// No nested streams
 }
@@ -116,9 +407,10 @@ void AudioStreamPlaybackOsc::_tag_used_streams() {
 // AudioStreamOsc Implementation
 
 AudioStreamOsc::AudioStreamOsc() {
-	waveform_type = WAVEFORM_SINE;
-	frequency = 440.0f; // A440
-	amplitude_db = -6.0f; // ~0.5 linear amplitude by default
+	// Defaults live in Params: sine, A440, -6 dB (~0.5 linear amplitude), unison off
+	set_amplitude_db(-6.0f);
+	_update_unison(params.edit());
+	params.publish();
 }
 
 AudioStreamOsc::~AudioStreamOsc() {
@@ -136,52 +428,435 @@ void AudioStreamOsc::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_amplitude_linear"), &AudioStreamOsc::get_amplitude_linear);
 
-	ADD_PROPERTY(PropertyInfo(Variant::INT, "waveform_type", PROPERTY_HINT_ENUM, "Sine,Saw,Square"), 
+	ClassDB::bind_method(D_METHOD("set_pulse_width", "width"), &AudioStreamOsc::set_pulse_width);
+	ClassDB::bind_method(D_METHOD("get_pulse_width"), &AudioStreamOsc::get_pulse_width);
+
+	ClassDB::bind_method(D_METHOD("set_band_limited", "enabled"), &AudioStreamOsc::set_band_limited);
+	ClassDB::bind_method(D_METHOD("is_band_limited"), &AudioStreamOsc::is_band_limited);
+
+	ClassDB::bind_method(D_METHOD("set_noise_seed", "seed"), &AudioStreamOsc::set_noise_seed);
+	ClassDB::bind_method(D_METHOD("get_noise_seed"), &AudioStreamOsc::get_noise_seed);
+
+	ClassDB::bind_method(D_METHOD("set_unison_voices", "voices"), &AudioStreamOsc::set_unison_voices);
+	ClassDB::bind_method(D_METHOD("get_unison_voices"), &AudioStreamOsc::get_unison_voices);
+
+	ClassDB::bind_method(D_METHOD("set_unison_detune", "cents"), &AudioStreamOsc::set_unison_detune);
+	ClassDB::bind_method(D_METHOD("get_unison_detune"), &AudioStreamOsc::get_unison_detune);
+
+	ClassDB::bind_method(D_METHOD("set_unison_spread", "spread"), &AudioStreamOsc::set_unison_spread);
+	ClassDB::bind_method(D_METHOD("get_unison_spread"), &AudioStreamOsc::get_unison_spread);
+
+	ClassDB::bind_method(D_METHOD("set_envelope_enabled", "enabled"), &AudioStreamOsc::set_envelope_enabled);
+	ClassDB::bind_method(D_METHOD("is_envelope_enabled"), &AudioStreamOsc::is_envelope_enabled);
+
+	ClassDB::bind_method(D_METHOD("set_attack_time", "seconds"), &AudioStreamOsc::set_attack_time);
+	ClassDB::bind_method(D_METHOD("get_attack_time"), &AudioStreamOsc::get_attack_time);
+
+	ClassDB::bind_method(D_METHOD("set_decay_time", "seconds"), &AudioStreamOsc::set_decay_time);
+	ClassDB::bind_method(D_METHOD("get_decay_time"), &AudioStreamOsc::get_decay_time);
+
+	ClassDB::bind_method(D_METHOD("set_sustain_level", "level"), &AudioStreamOsc::set_sustain_level);
+	ClassDB::bind_method(D_METHOD("get_sustain_level"), &AudioStreamOsc::get_sustain_level);
+
+	ClassDB::bind_method(D_METHOD("set_release_time", "seconds"), &AudioStreamOsc::set_release_time);
+	ClassDB::bind_method(D_METHOD("get_release_time"), &AudioStreamOsc::get_release_time);
+
+	ClassDB::bind_method(D_METHOD("set_envelope_curve", "curve"), &AudioStreamOsc::set_envelope_curve);
+	ClassDB::bind_method(D_METHOD("get_envelope_curve"), &AudioStreamOsc::get_envelope_curve);
+
+	ClassDB::bind_method(D_METHOD("set_modulation_interval", "samples"), &AudioStreamOsc::set_modulation_interval);
+	ClassDB::bind_method(D_METHOD("get_modulation_interval"), &AudioStreamOsc::get_modulation_interval);
+
+	ClassDB::bind_method(D_METHOD("set_lfo_rate", "lfo", "rate"), &AudioStreamOsc::set_lfo_rate);
+	ClassDB::bind_method(D_METHOD("get_lfo_rate", "lfo"), &AudioStreamOsc::get_lfo_rate);
+
+	ClassDB::bind_method(D_METHOD("set_lfo_shape", "lfo", "shape"), &AudioStreamOsc::set_lfo_shape);
+	ClassDB::bind_method(D_METHOD("get_lfo_shape", "lfo"), &AudioStreamOsc::get_lfo_shape);
+
+	ClassDB::bind_method(D_METHOD("add_modulation", "lfo", "destination", "amount"), &AudioStreamOsc::add_modulation);
+	ClassDB::bind_method(D_METHOD("set_modulation_amount", "index", "amount"), &AudioStreamOsc::set_modulation_amount);
+	ClassDB::bind_method(D_METHOD("get_modulation_amount", "index"), &AudioStreamOsc::get_modulation_amount);
+	ClassDB::bind_method(D_METHOD("remove_modulation", "index"), &AudioStreamOsc::remove_modulation);
+	ClassDB::bind_method(D_METHOD("clear_modulations"), &AudioStreamOsc::clear_modulations);
+	ClassDB::bind_method(D_METHOD("get_modulation_count"), &AudioStreamOsc::get_modulation_count);
+
+	ClassDB::bind_method(D_METHOD("set_modulations", "routes"), &AudioStreamOsc::set_modulations);
+	ClassDB::bind_method(D_METHOD("get_modulations"), &AudioStreamOsc::get_modulations);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "waveform_type", PROPERTY_HINT_ENUM, "Sine,Saw,Square,Triangle,Pulse,White Noise,Pink Noise,Brown Noise"), 
 				 "set_waveform_type", "get_waveform_type");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "frequency", PROPERTY_HINT_RANGE, "20.0,20000.0,0.01,suffix:Hz"), 
 				 "set_frequency", "get_frequency");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "amplitude_db", PROPERTY_HINT_RANGE, "-60.0,0.0,0.01,suffix:dB"), 
 				 "set_amplitude_db", "get_amplitude_db");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "pulse_width", PROPERTY_HINT_RANGE, "0.01,0.99,0.01"), "set_pulse_width", "get_pulse_width");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "band_limited"), "set_band_limited", "is_band_limited");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "noise_seed"), "set_noise_seed", "get_noise_seed");
+
+	ADD_GROUP("Unison", "unison_");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "unison_voices", PROPERTY_HINT_RANGE, "1,16,1"), "set_unison_voices", "get_unison_voices");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "unison_detune", PROPERTY_HINT_RANGE, "0.0,100.0,0.1,suffix:cents"), "set_unison_detune", "get_unison_detune");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "unison_spread", PROPERTY_HINT_RANGE, "0.0,1.0,0.01"), "set_unison_spread", "get_unison_spread");
+
+	ADD_GROUP("Envelope", "");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "envelope_enabled"), "set_envelope_enabled", "is_envelope_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "attack_time", PROPERTY_HINT_RANGE, "0.0,5.0,0.001,suffix:s"), "set_attack_time", "get_attack_time");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "decay_time", PROPERTY_HINT_RANGE, "0.0,10.0,0.001,suffix:s"), "set_decay_time", "get_decay_time");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "sustain_level", PROPERTY_HINT_RANGE, "0.0,1.0,0.01"), "set_sustain_level", "get_sustain_level");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "release_time", PROPERTY_HINT_RANGE, "0.001,10.0,0.001,suffix:s"), "set_release_time", "get_release_time");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "envelope_curve", PROPERTY_HINT_ENUM, "Linear,Exponential"), "set_envelope_curve", "get_envelope_curve");
+
+	ADD_GROUP("Modulation", "");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "modulation_interval", PROPERTY_HINT_RANGE, "1,256,1,suffix:samples"), "set_modulation_interval", "get_modulation_interval");
+	ADD_PROPERTYI(PropertyInfo(Variant::FLOAT, "lfo_1_rate", PROPERTY_HINT_RANGE, "0.01,50.0,0.01,suffix:Hz"), "set_lfo_rate", "get_lfo_rate", 0);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "lfo_1_shape", PROPERTY_HINT_ENUM, "Sine,Triangle,Saw,Square,Random"), "set_lfo_shape", "get_lfo_shape", 0);
+	ADD_PROPERTYI(PropertyInfo(Variant::FLOAT, "lfo_2_rate", PROPERTY_HINT_RANGE, "0.01,50.0,0.01,suffix:Hz"), "set_lfo_rate", "get_lfo_rate", 1);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "lfo_2_shape", PROPERTY_HINT_ENUM, "Sine,Triangle,Saw,Square,Random"), "set_lfo_shape", "get_lfo_shape", 1);
+	ADD_PROPERTYI(PropertyInfo(Variant::FLOAT, "lfo_3_rate", PROPERTY_HINT_RANGE, "0.01,50.0,0.01,suffix:Hz"), "set_lfo_rate", "get_lfo_rate", 2);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "lfo_3_shape", PROPERTY_HINT_ENUM, "Sine,Triangle,Saw,Square,Random"), "set_lfo_shape", "get_lfo_shape", 2);
+	ADD_PROPERTYI(PropertyInfo(Variant::FLOAT, "lfo_4_rate", PROPERTY_HINT_RANGE, "0.01,50.0,0.01,suffix:Hz"), "set_lfo_rate", "get_lfo_rate", 3);
+	ADD_PROPERTYI(PropertyInfo(Variant::INT, "lfo_4_shape", PROPERTY_HINT_ENUM, "Sine,Triangle,Saw,Square,Random"), "set_lfo_shape", "get_lfo_shape", 3);
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "modulations", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_modulations", "get_modulations");
 
 	BIND_ENUM_CONSTANT(WAVEFORM_SINE);
 	BIND_ENUM_CONSTANT(WAVEFORM_SAW);
 	BIND_ENUM_CONSTANT(WAVEFORM_SQUARE);
+	BIND_ENUM_CONSTANT(WAVEFORM_TRIANGLE);
+	BIND_ENUM_CONSTANT(WAVEFORM_PULSE);
+	BIND_ENUM_CONSTANT(WAVEFORM_NOISE_WHITE);
+	BIND_ENUM_CONSTANT(WAVEFORM_NOISE_PINK);
+	BIND_ENUM_CONSTANT(WAVEFORM_NOISE_BROWN);
+
+	BIND_ENUM_CONSTANT(ENVELOPE_LINEAR);
+	BIND_ENUM_CONSTANT(ENVELOPE_EXPONENTIAL);
+
+	BIND_ENUM_CONSTANT(LFO_SINE);
+	BIND_ENUM_CONSTANT(LFO_TRIANGLE);
+	BIND_ENUM_CONSTANT(LFO_SAW);
+	BIND_ENUM_CONSTANT(LFO_SQUARE);
+	BIND_ENUM_CONSTANT(LFO_RANDOM);
+
+	BIND_ENUM_CONSTANT(MOD_PITCH);
+	BIND_ENUM_CONSTANT(MOD_AMPLITUDE);
+	BIND_ENUM_CONSTANT(MOD_PULSE_WIDTH);
 }
 
 void AudioStreamOsc::set_waveform_type(WaveformType p_type) {
-	waveform_type = p_type;
+	params.edit().waveform_type = p_type;
+	params.publish();
 }
 
 AudioStreamOsc::WaveformType AudioStreamOsc::get_waveform_type() const {
-	return waveform_type;
+	return params.get().waveform_type;
 }
 
 void AudioStreamOsc::set_frequency(float p_frequency) {
-	frequency = CLAMP(p_frequency, 20.0f, 20000.0f);
+	params.edit().frequency = CLAMP(p_frequency, 20.0f, 20000.0f);
+	params.publish();
 }
 
 float AudioStreamOsc::get_frequency() const {
-	return frequency;
+	return params.get().frequency;
 }
 
 void AudioStreamOsc::set_amplitude_db(float p_amplitude_db) {
-	amplitude_db = CLAMP(p_amplitude_db, -60.0f, 0.0f);
+	Params &edit = params.edit();
+	edit.amplitude_db = CLAMP(p_amplitude_db, -60.0f, 0.0f);
+
+	// Convert decibels to linear amplitude here, so the audio thread never does
+	// Formula: linear = 10^(dB/20)
+	edit.amplitude_linear = std::pow(10.0f, edit.amplitude_db / 20.0f);
+	params.publish();
 }
 
 float AudioStreamOsc::get_amplitude_db() const {
-	return amplitude_db;
+	return params.get().amplitude_db;
 }
 
 float AudioStreamOsc::get_amplitude_linear() const {
-	// Convert decibels to linear amplitude
-	// Formula: linear = 10^(dB/20)
-	return std::pow(10.0f, amplitude_db / 20.0f);
+	return params.get().amplitude_linear;
+}
+
+void AudioStreamOsc::set_pulse_width(float p_width) {
+	params.edit().pulse_width = CLAMP(p_width, 0.01f, 0.99f);
+	params.publish();
+}
+
+float AudioStreamOsc::get_pulse_width() const {
+	return params.get().pulse_width;
+}
+
+void AudioStreamOsc::set_band_limited(bool p_enabled) {
+	params.edit().band_limited = p_enabled;
+	params.publish();
+}
+
+bool AudioStreamOsc::is_band_limited() const {
+	return params.get().band_limited;
+}
+
+void AudioStreamOsc::set_noise_seed(int p_seed) {
+	params.edit().noise_seed = p_seed;
+	params.publish();
+}
+
+int AudioStreamOsc::get_noise_seed() const {
+	return params.get().noise_seed;
+}
+
+void AudioStreamOsc::set_unison_voices(int p_voices) {
+	Params &edit = params.edit();
+	edit.unison_voices = CLAMP(p_voices, 1, MAX_UNISON);
+	_update_unison(edit);
+	params.publish();
+}
+
+int AudioStreamOsc::get_unison_voices() const {
+	return params.get().unison_voices;
+}
+
+void AudioStreamOsc::set_unison_detune(float p_cents) {
+	Params &edit = params.edit();
+	edit.unison_detune = CLAMP(p_cents, 0.0f, 100.0f);
+	_update_unison(edit);
+	params.publish();
+}
+
+float AudioStreamOsc::get_unison_detune() const {
+	return params.get().unison_detune;
+}
+
+void AudioStreamOsc::set_unison_spread(float p_spread) {
+	Params &edit = params.edit();
+	edit.unison_spread = CLAMP(p_spread, 0.0f, 1.0f);
+	_update_unison(edit);
+	params.publish();
+}
+
+float AudioStreamOsc::get_unison_spread() const {
+	return params.get().unison_spread;
+}
+
+void AudioStreamOsc::set_envelope_enabled(bool p_enabled) {
+	params.edit().envelope_enabled = p_enabled;
+	params.publish();
+}
+
+bool AudioStreamOsc::is_envelope_enabled() const {
+	return params.get().envelope_enabled;
+}
+
+void AudioStreamOsc::set_attack_time(float p_seconds) {
+	params.edit().envelope.attack = CLAMP(p_seconds, 0.0f, 5.0f);
+	params.publish();
+}
+
+float AudioStreamOsc::get_attack_time() const {
+	return params.get().envelope.attack;
+}
+
+void AudioStreamOsc::set_decay_time(float p_seconds) {
+	params.edit().envelope.decay = CLAMP(p_seconds, 0.0f, 10.0f);
+	params.publish();
+}
+
+float AudioStreamOsc::get_decay_time() const {
+	return params.get().envelope.decay;
+}
+
+void AudioStreamOsc::set_sustain_level(float p_level) {
+	params.edit().envelope.sustain = CLAMP(p_level, 0.0f, 1.0f);
+	params.publish();
+}
+
+float AudioStreamOsc::get_sustain_level() const {
+	return params.get().envelope.sustain;
+}
+
+void AudioStreamOsc::set_release_time(float p_seconds) {
+	params.edit().envelope.release = CLAMP(p_seconds, 0.001f, 10.0f);
+	params.publish();
+}
+
+float AudioStreamOsc::get_release_time() const {
+	return params.get().envelope.release;
+}
+
+void AudioStreamOsc::set_envelope_curve(EnvelopeCurve p_curve) {
+	params.edit().envelope.curve = (ADSREnvelope::Curve)p_curve;
+	params.publish();
+}
+
+AudioStreamOsc::EnvelopeCurve AudioStreamOsc::get_envelope_curve() const {
+	return (EnvelopeCurve)params.get().envelope.curve;
+}
+
+void AudioStreamOsc::set_modulation_interval(int p_samples) {
+	params.edit().modulation_interval = CLAMP(p_samples, 1, 256);
+	params.publish();
+}
+
+int AudioStreamOsc::get_modulation_interval() const {
+	return params.get().modulation_interval;
+}
+
+void AudioStreamOsc::set_lfo_rate(int p_lfo, float p_rate) {
+	ERR_FAIL_INDEX(p_lfo, MAX_LFOS);
+	params.edit().lfo_rate[p_lfo] = CLAMP(p_rate, 0.01f, 50.0f);
+	params.publish();
+}
+
+float AudioStreamOsc::get_lfo_rate(int p_lfo) const {
+	ERR_FAIL_INDEX_V(p_lfo, MAX_LFOS, 0.0f);
+	return params.get().lfo_rate[p_lfo];
+}
+
+void AudioStreamOsc::set_lfo_shape(int p_lfo, LFOShape p_shape) {
+	ERR_FAIL_INDEX(p_lfo, MAX_LFOS);
+	params.edit().lfo_shape[p_lfo] = (ControlLFO::Shape)p_shape;
+	params.publish();
+}
+
+AudioStreamOsc::LFOShape AudioStreamOsc::get_lfo_shape(int p_lfo) const {
+	ERR_FAIL_INDEX_V(p_lfo, MAX_LFOS, LFO_SINE);
+	return (LFOShape)params.get().lfo_shape[p_lfo];
+}
+
+int AudioStreamOsc::add_modulation(int p_lfo, ModDestination p_destination, float p_amount) {
+	ERR_FAIL_INDEX_V(p_lfo, MAX_LFOS, -1);
+	ERR_FAIL_INDEX_V(p_destination, MOD_DESTINATION_MAX, -1);
+	Params &edit = params.edit();
+	ERR_FAIL_COND_V_MSG(edit.modulation_count >= ModMatrix::MAX_ROUTES, -1, "Modulation matrix is full.");
+
+	int index = edit.modulation_count++;
+	edit.modulations[index].source = (uint16_t)p_lfo;
+	edit.modulations[index].destination = (uint16_t)p_destination;
+	edit.modulations[index].amount = p_amount;
+	_update_routing(edit);
+	params.publish();
+	return index;
+}
+
+void AudioStreamOsc::set_modulation_amount(int p_index, float p_amount) {
+	Params &edit = params.edit();
+	ERR_FAIL_INDEX(p_index, edit.modulation_count);
+	edit.modulations[p_index].amount = p_amount;
+	_update_routing(edit);
+	params.publish();
+}
+
+float AudioStreamOsc::get_modulation_amount(int p_index) const {
+	const Params &current = params.get();
+	ERR_FAIL_INDEX_V(p_index, current.modulation_count, 0.0f);
+	return current.modulations[p_index].amount;
+}
+
+void AudioStreamOsc::remove_modulation(int p_index) {
+	Params &edit = params.edit();
+	ERR_FAIL_INDEX(p_index, edit.modulation_count);
+	for (int i = p_index; i < edit.modulation_count - 1; i++) {
+		edit.modulations[i] = edit.modulations[i + 1];
+	}
+	edit.modulation_count--;
+	_update_routing(edit);
+	params.publish();
+}
+
+void AudioStreamOsc::clear_modulations() {
+	Params &edit = params.edit();
+	edit.modulation_count = 0;
+	_update_routing(edit);
+	params.publish();
+}
+
+int AudioStreamOsc::get_modulation_count() const {
+	return params.get().modulation_count;
+}
+
+void AudioStreamOsc::set_modulations(const PackedFloat32Array &p_routes) {
+	Params &edit = params.edit();
+	edit.modulation_count = 0;
+	for (int64_t i = 0; i + 2 < p_routes.size() && edit.modulation_count < ModMatrix::MAX_ROUTES; i += 3) {
+		int lfo = (int)p_routes[i];
+		int destination = (int)p_routes[i + 1];
+		if (lfo < 0 || lfo >= MAX_LFOS || destination < 0 || destination >= MOD_DESTINATION_MAX) {
+			WARN_PRINT("Invalid modulation route skipped.");
+			continue;
+		}
+		ModMatrix::Route &route = edit.modulations[edit.modulation_count++];
+		route.source = (uint16_t)lfo;
+		route.destination = (uint16_t)destination;
+		route.amount = p_routes[i + 2];
+	}
+	_update_routing(edit);
+	params.publish();
+}
+
+PackedFloat32Array AudioStreamOsc::get_modulations() const {
+	const Params &current = params.get();
+	PackedFloat32Array routes;
+	routes.resize(current.modulation_count * 3);
+	for (int i = 0; i < current.modulation_count; i++) {
+		routes.set(i * 3, current.modulations[i].source);
+		routes.set(i * 3 + 1, current.modulations[i].destination);
+		routes.set(i * 3 + 2, current.modulations[i].amount);
+	}
+	return routes;
+}
+
+void AudioStreamOsc::_update_routing(Params &r_params) {
+	// Rebuilt only here, when the patch changes; the playback just copies the result
+	ModMatrix::compile(r_params.modulations, r_params.modulation_count, MAX_LFOS, MOD_DESTINATION_MAX, r_params.routing);
+}
+
+void AudioStreamOsc::_update_unison(Params &r_params) {
+	// Copies are spaced evenly from -1 (lowest, leftmost) to +1 (highest, rightmost)
+	int voices = r_params.unison_voices;
+	float normalize = 1.0f / std::sqrt((float)voices); // Uncorrelated copies add up in power
+	for (int i = 0; i < MAX_UNISON; i++) {
+		float position = voices > 1 ? 2.0f * i / (voices - 1) - 1.0f : 0.0f;
+		r_params.unison_ratio[i] = std::pow(2.0f, position * r_params.unison_detune * 0.5f / 1200.0f);
+
+		// Equal-power pan, scaled so a centered copy has unity gain on both sides
+		float angle = (position * r_params.unison_spread + 1.0f) * (float)(Math_PI * 0.25);
+		r_params.unison_pan_left[i] = std::cos(angle) * (float)Math_SQRT2 * normalize;
+		r_params.unison_pan_right[i] = std::sin(angle) * (float)Math_SQRT2 * normalize;
+	}
+}
+
+OscKernels::Shape AudioStreamOsc::get_kernel_shape(WaveformType p_type, bool p_band_limited) {
+	switch (p_type) {
+		case WAVEFORM_SINE:
+			return OscKernels::SHAPE_SINE;
+		case WAVEFORM_SAW:
+			return p_band_limited ? OscKernels::SHAPE_SAW_BLEP : OscKernels::SHAPE_SAW;
+		case WAVEFORM_SQUARE:
+			return p_band_limited ? OscKernels::SHAPE_SQUARE_BLEP : OscKernels::SHAPE_SQUARE;
+		case WAVEFORM_TRIANGLE:
+			return p_band_limited ? OscKernels::SHAPE_TRIANGLE_BLAMP : OscKernels::SHAPE_TRIANGLE;
+		case WAVEFORM_PULSE:
+			return p_band_limited ? OscKernels::SHAPE_PULSE_BLEP : OscKernels::SHAPE_PULSE;
+		default:
+			break;
+	}
+	return OscKernels::SHAPE_SINE;
+}
+
+OscKernels::NoiseColor AudioStreamOsc::get_noise_color(WaveformType p_type) {
+	switch (p_type) {
+		case WAVEFORM_NOISE_PINK:
+			return OscKernels::NOISE_PINK;
+		case WAVEFORM_NOISE_BROWN:
+			return OscKernels::NOISE_BROWN;
+		default:
+			return OscKernels::NOISE_WHITE;
+	}
 }
 
 Ref<AudioStreamPlayback> AudioStreamOsc::_instantiate_playback() const {
 	Ref<AudioStreamPlaybackOsc> playback;
 	playback.instantiate();
-	playback->set_stream(Ref<AudioStreamOsc>(this));
+	playback->set_stream(Ref<AudioStreamOsc>(this), noise_voices.fetch_add(1, std::memory_order_relaxed));
 	return playback;
 }
 
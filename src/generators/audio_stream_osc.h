@@ -13,6 +13,14 @@
 #include <godot_cpp/classes/audio_stream_playback.hpp>
 #include <godot_cpp/classes/audio_server.hpp>
 
+#include "adsr_envelope.h"
+#include "modulation.h"
+#include "osc_kernels.h"
+#include "param_snapshot.h"
+
+#include <atomic>
+#include <cstdint>
+
 using namespace godot;
 
 class AudioStreamOsc;
@@ -20,12 +28,71 @@ class AudioStreamOsc;
 class AudioStreamPlaybackOsc : public AudioStreamPlayback {
 	GDCLASS(AudioStreamPlaybackOsc, AudioStreamPlayback)
 
+public:
+	static constexpr int MAX_UNISON = 2 * OscKernels::GROUP_SIZE;
+	static constexpr int MAX_LFOS = 4;
+	static constexpr int MOD_DESTINATIONS = 3; // AudioStreamOsc::ModDestination
+
 private:
 	Ref<AudioStreamOsc> stream;
-	double phase;
+	uint64_t phase = 0; // OscKernels::State fixed point
 	double sample_rate;
 
-	float generate_sample();
+	// Last parameter snapshot, kept when a read overlaps a write
+	OscKernels::Shape shape = OscKernels::SHAPE_SINE;
+	float frequency = 440.0f;
+	float amplitude = 0.0f;
+	float pulse_width = 0.5f;
+	ParamRamp amplitude_ramp;
+
+	// Unison copies, rendered as voice groups when unison_voices > 1
+	int unison_voices = 1;
+	float unison_ratio[MAX_UNISON];
+	float unison_pan_left[MAX_UNISON];
+	float unison_pan_right[MAX_UNISON];
+	uint32_t unison_phase[MAX_UNISON];
+	uint32_t random_state = 0;
+
+	// Noise waveforms: the generator is seeded from the stream's noise_seed and this playback's voice
+	bool noise = false;
+	OscKernels::NoiseColor noise_color = OscKernels::NOISE_WHITE;
+	OscKernels::NoiseState noise_state;
+	uint32_t noise_voice = 0;
+	int noise_seed = 0;
+
+	// Game thread -> audio thread: note-on count in the upper bits, gate held in bit 0
+	std::atomic<uint32_t> gate{ 0 };
+	std::atomic<float> gate_velocity{ 1.0f };
+
+	// Amplitude envelope, audio thread only
+	bool envelope_enabled = false;
+	ADSREnvelope::Settings envelope;
+	ADSREnvelope::Stage envelope_stage = ADSREnvelope::STAGE_IDLE;
+	ADSREnvelope::Segment envelope_segment; // length counts down to the next stage
+	float envelope_value = 0.0f;
+	float envelope_peak = 1.0f;
+	uint32_t gate_seen = 0;
+
+	// Modulation, evaluated every modulation_interval samples
+	int modulation_interval = 16;
+	float lfo_rate[MAX_LFOS] = {};
+	ControlLFO::Shape lfo_shape[MAX_LFOS] = {};
+	ModMatrix::Routing routing;
+	ControlLFO lfos[MAX_LFOS];
+	int32_t control_remaining = 0; // Samples until the next tick
+	float modulation_from[MOD_DESTINATIONS]; // Destination values at the last two ticks, in the units
+	float modulation_to[MOD_DESTINATIONS]; // _render() takes: frequency ratio, gain, pulse width offset
+
+	void _randomize_unison_phases();
+	void _seed_noise(int p_seed);
+	void _reset_modulation();
+	void _tick_modulation(float p_rate_scale);
+	void _render(AudioFrame *p_buffer, int p_frames, double p_increment, float p_pulse_width, float p_amplitude, float p_amplitude_step);
+	void _process_gate();
+	void _enter_envelope_stage(ADSREnvelope::Stage p_stage);
+	void _apply_envelope(float *r_block, int p_count);
+	void _load_envelope(OscKernels::VoiceGroup *r_groups, int p_group_count, int p_lanes) const;
+	void _mix_unison(AudioFrame *p_buffer, int p_frames, double p_increment, float p_pulse_width, float p_amplitude, float p_amplitude_step);
 
 protected:
 	static void _bind_methods();
@@ -34,7 +101,12 @@ public:
 	AudioStreamPlaybackOsc();
 	~AudioStreamPlaybackOsc();
 
-	void set_stream(const Ref<AudioStreamOsc> &p_stream);
+	// p_voice tells this playback's noise sequence apart from the stream's other playbacks
+	void set_stream(const Ref<AudioStreamOsc> &p_stream, uint32_t p_voice = 0);
+
+	// Game thread; gate the amplitude envelope (when enabled) from the start of the next mix block
+	void note_on(float p_velocity = 1.0f);
+	void note_off();
 
 	virtual void _start(double p_from_pos = 0.0) override;
 	virtual void _stop() override;
@@ -53,13 +125,74 @@ public:
 	enum WaveformType {
 		WAVEFORM_SINE,
 		WAVEFORM_SAW,
-		WAVEFORM_SQUARE
+		WAVEFORM_SQUARE,
+		WAVEFORM_TRIANGLE,
+		WAVEFORM_PULSE,
+		WAVEFORM_NOISE_WHITE,
+		WAVEFORM_NOISE_PINK,
+		WAVEFORM_NOISE_BROWN,
+	};
+
+	enum EnvelopeCurve {
+		ENVELOPE_LINEAR = ADSREnvelope::CURVE_LINEAR,
+		ENVELOPE_EXPONENTIAL = ADSREnvelope::CURVE_EXPONENTIAL,
+	};
+
+	enum LFOShape {
+		LFO_SINE = ControlLFO::SHAPE_SINE,
+		LFO_TRIANGLE = ControlLFO::SHAPE_TRIANGLE,
+		LFO_SAW = ControlLFO::SHAPE_SAW,
+		LFO_SQUARE = ControlLFO::SHAPE_SQUARE,
+		LFO_RANDOM = ControlLFO::SHAPE_RANDOM,
+	};
+
+	enum ModDestination {
+		MOD_PITCH, // Amount in semitones
+		MOD_AMPLITUDE, // Amount as a fraction of the amplitude
+		MOD_PULSE_WIDTH, // Amount added to pulse_width
+		MOD_DESTINATION_MAX,
+	};
+
+	static constexpr int MAX_UNISON = AudioStreamPlaybackOsc::MAX_UNISON;
+	static constexpr int MAX_LFOS = AudioStreamPlaybackOsc::MAX_LFOS;
+
+	// Everything the playback reads on the audio thread
+	struct Params {
+		WaveformType waveform_type = WAVEFORM_SINE;
+		float frequency = 440.0f;
+		float amplitude_db = -6.0f;
+		float amplitude_linear = 0.5f;
+		float pulse_width = 0.5f;
+		bool band_limited = true;
+		int noise_seed = 0;
+
+		int unison_voices = 1;
+		float unison_detune = 20.0f;
+		float unison_spread = 0.5f;
+		// Derived from the three above in the setters: frequency ratio and channel gains per copy
+		float unison_ratio[MAX_UNISON] = {};
+		float unison_pan_left[MAX_UNISON] = {};
+		float unison_pan_right[MAX_UNISON] = {};
+
+		// Off: a continuous tone. On: silent until the playback's note_on()
+		bool envelope_enabled = false;
+		ADSREnvelope::Settings envelope;
+
+		int modulation_interval = 16;
+		float lfo_rate[MAX_LFOS] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		ControlLFO::Shape lfo_shape[MAX_LFOS] = {};
+		// Routes in edit order (sources are LFO indices), and the compiled form the playback evaluates
+		ModMatrix::Route modulations[ModMatrix::MAX_ROUTES];
+		int modulation_count = 0;
+		ModMatrix::Routing routing;
 	};
 
 private:
-	WaveformType waveform_type;
-	float frequency;
-	float amplitude_db;
+	ParamSnapshot<Params> params;
+	mutable std::atomic<uint32_t> noise_voices{ 0 }; // Playbacks instantiated so far
+
+	static void _update_unison(Params &r_params);
+	static void _update_routing(Params &r_params);
 
 protected:
 	static void _bind_methods();
@@ -79,6 +212,79 @@ public:
 
 	float get_amplitude_linear() const;
 
+	void set_pulse_width(float p_width);
+	float get_pulse_width() const;
+
+	void set_band_limited(bool p_enabled);
+	bool is_band_limited() const;
+
+	// Noise waveforms: the same seed renders the same noise. Playbacks of one stream get their own
+	// sequence each, in the order they are instantiated.
+	void set_noise_seed(int p_seed);
+	int get_noise_seed() const;
+
+	// Detuned copies of the waveform, 1 = off
+	void set_unison_voices(int p_voices);
+	int get_unison_voices() const;
+
+	// Cents between the lowest and the highest copy
+	void set_unison_detune(float p_cents);
+	float get_unison_detune() const;
+
+	// Stereo width of the copies, 0 = all centered, 1 = lowest copy hard left, highest hard right
+	void set_unison_spread(float p_spread);
+	float get_unison_spread() const;
+
+	void set_envelope_enabled(bool p_enabled);
+	bool is_envelope_enabled() const;
+
+	void set_attack_time(float p_seconds);
+	float get_attack_time() const;
+
+	void set_decay_time(float p_seconds);
+	float get_decay_time() const;
+
+	// Fraction of the note-on velocity held until note_off()
+	void set_sustain_level(float p_level);
+	float get_sustain_level() const;
+
+	void set_release_time(float p_seconds);
+	float get_release_time() const;
+
+	void set_envelope_curve(EnvelopeCurve p_curve);
+	EnvelopeCurve get_envelope_curve() const;
+
+	// Samples between modulation updates; destinations are interpolated in between
+	void set_modulation_interval(int p_samples);
+	int get_modulation_interval() const;
+
+	void set_lfo_rate(int p_lfo, float p_rate);
+	float get_lfo_rate(int p_lfo) const;
+
+	void set_lfo_shape(int p_lfo, LFOShape p_shape);
+	LFOShape get_lfo_shape(int p_lfo) const;
+
+	// Returns the index of the new route, -1 if the matrix is full
+	int add_modulation(int p_lfo, ModDestination p_destination, float p_amount);
+	void set_modulation_amount(int p_index, float p_amount);
+	float get_modulation_amount(int p_index) const;
+	void remove_modulation(int p_index);
+	void clear_modulations();
+	int get_modulation_count() const;
+
+	// Storage form of the routes: (lfo, destination, amount) triples
+	void set_modulations(const PackedFloat32Array &p_routes);
+	PackedFloat32Array get_modulations() const;
+
+	// Kernel for a waveform; band-limited variants for everything but the sine. Noise has no kernel
+	// shape (the sine is returned), see is_noise().
+	static OscKernels::Shape get_kernel_shape(WaveformType p_type, bool p_band_limited);
+	static bool is_noise(WaveformType p_type) { return p_type >= WAVEFORM_NOISE_WHITE; }
+	static OscKernels::NoiseColor get_noise_color(WaveformType p_type);
+
+	// Audio thread: consistent copy of the parameters; false keeps r_params unchanged
+	bool read_params(Params &r_params) const { return params.read(r_params); }
+
 	virtual Ref<AudioStreamPlayback> _instantiate_playback() const override;
 	virtual String _get_stream_name() const override;
 	virtual double _get_length() const override;
@@ -88,5 +294,8 @@ public:
 };
 
 VARIANT_ENUM_CAST(AudioStreamOsc::WaveformType);
+VARIANT_ENUM_CAST(AudioStreamOsc::EnvelopeCurve);
+VARIANT_ENUM_CAST(AudioStreamOsc::LFOShape);
+VARIANT_ENUM_CAST(AudioStreamOsc::ModDestination);
 
 #endif // AUDIO_STREAM_OSC_H
\ No newline at end of file
@@ -0,0 +1,701 @@
+/**************************************************************************/
+/*  audio_stream_synth.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "audio_stream_synth.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <cmath>
+
+// Samples rendered per kernel call; the mono scratch lives on the stack
+static const int MIX_BLOCK_SIZE = 256;
+
+// Events drained per ring read
+static const int EVENT_BATCH = 32;
+
+// SynthVoicePool Implementation
+
+void SynthVoicePool::reset() {
+	free_voices = List();
+	held_voices = List();
+	releasing_voices = List();
+	for (int b = 0; b < VELOCITY_BUCKETS; b++) {
+		velocity_buckets[b] = List();
+	}
+	for (int n = 0; n < NOTE_COUNT; n++) {
+		note_voice[n] = NONE;
+	}
+
+	for (int v = 0; v < MAX_VOICES; v++) {
+		phase[v] = 0;
+		frequency[v] = 0.0f;
+		gain[v] = 0.0f;
+		velocity[v] = 0.0f;
+		envelope_mul[v] = 1.0f;
+		envelope_add[v] = 0.0f;
+		envelope_min[v] = 0.0f;
+		envelope_max[v] = 0.0f;
+		envelope_end[v] = 0.0f;
+		envelope_remaining[v] = -1;
+		envelope_stage[v] = ADSREnvelope::STAGE_IDLE;
+		note[v] = 0;
+		state[v] = VOICE_FREE;
+		bucket_prev[v] = NONE;
+		bucket_next[v] = NONE;
+		_push_back(free_voices, v);
+	}
+}
+
+SynthVoicePool::List &SynthVoicePool::_list_for(uint8_t p_state) {
+	switch (p_state) {
+		case VOICE_HELD:
+			return held_voices;
+		case VOICE_RELEASING:
+			return releasing_voices;
+		default:
+			return free_voices;
+	}
+}
+
+int SynthVoicePool::_bucket_for(float p_velocity) {
+	int bucket = (int)(p_velocity * VELOCITY_BUCKETS);
+	return CLAMP(bucket, 0, VELOCITY_BUCKETS - 1);
+}
+
+void SynthVoicePool::_push_back(List &r_list, int p_voice) {
+	prev[p_voice] = r_list.tail;
+	next[p_voice] = NONE;
+	if (r_list.tail != NONE) {
+		next[r_list.tail] = p_voice;
+	} else {
+		r_list.head = p_voice;
+	}
+	r_list.tail = p_voice;
+	r_list.count++;
+}
+
+void SynthVoicePool::_remove(List &r_list, int p_voice) {
+	if (prev[p_voice] != NONE) {
+		next[prev[p_voice]] = next[p_voice];
+	} else {
+		r_list.head = next[p_voice];
+	}
+	if (next[p_voice] != NONE) {
+		prev[next[p_voice]] = prev[p_voice];
+	} else {
+		r_list.tail = prev[p_voice];
+	}
+	prev[p_voice] = NONE;
+	next[p_voice] = NONE;
+	r_list.count--;
+}
+
+void SynthVoicePool::_bucket_push_back(int p_bucket, int p_voice) {
+	List &list = velocity_buckets[p_bucket];
+	bucket_prev[p_voice] = list.tail;
+	bucket_next[p_voice] = NONE;
+	if (list.tail != NONE) {
+		bucket_next[list.tail] = p_voice;
+	} else {
+		list.head = p_voice;
+	}
+	list.tail = p_voice;
+	list.count++;
+}
+
+void SynthVoicePool::_bucket_remove(int p_bucket, int p_voice) {
+	List &list = velocity_buckets[p_bucket];
+	if (bucket_prev[p_voice] != NONE) {
+		bucket_next[bucket_prev[p_voice]] = bucket_next[p_voice];
+	} else {
+		list.head = bucket_next[p_voice];
+	}
+	if (bucket_next[p_voice] != NONE) {
+		bucket_prev[bucket_next[p_voice]] = bucket_prev[p_voice];
+	} else {
+		list.tail = bucket_prev[p_voice];
+	}
+	bucket_prev[p_voice] = NONE;
+	bucket_next[p_voice] = NONE;
+	list.count--;
+}
+
+void SynthVoicePool::_detach(int p_voice) {
+	_remove(_list_for(state[p_voice]), p_voice);
+	if (state[p_voice] == VOICE_HELD) {
+		_bucket_remove(_bucket_for(velocity[p_voice]), p_voice);
+		if (note_voice[note[p_voice]] == p_voice) {
+			note_voice[note[p_voice]] = NONE;
+		}
+	}
+}
+
+int SynthVoicePool::allocate(StealMode p_mode, int p_polyphony, bool &r_stolen) {
+	int voice = NONE;
+	r_stolen = false;
+
+	if (get_active_count() < p_polyphony && free_voices.head != NONE) {
+		voice = free_voices.head;
+		_remove(free_voices, voice);
+		return voice;
+	}
+
+	// Voices already fading out go first, whichever mode is set
+	if (releasing_voices.head != NONE) {
+		voice = releasing_voices.head;
+	} else if (p_mode == STEAL_QUIETEST) {
+		for (int b = 0; b < VELOCITY_BUCKETS && voice == NONE; b++) {
+			voice = velocity_buckets[b].head;
+		}
+	} else {
+		voice = held_voices.head;
+	}
+
+	if (voice == NONE) {
+		return NONE;
+	}
+
+	_detach(voice);
+	state[voice] = VOICE_FREE;
+	r_stolen = true;
+	return voice;
+}
+
+void SynthVoicePool::hold(int p_voice, int p_note, float p_velocity) {
+	note[p_voice] = (uint8_t)p_note;
+	velocity[p_voice] = p_velocity;
+	state[p_voice] = VOICE_HELD;
+	_push_back(held_voices, p_voice);
+	_bucket_push_back(_bucket_for(p_velocity), p_voice);
+	note_voice[p_note] = p_voice;
+}
+
+void SynthVoicePool::release(int p_voice) {
+	ERR_FAIL_COND(state[p_voice] != VOICE_HELD);
+	_detach(p_voice);
+	state[p_voice] = VOICE_RELEASING;
+	_push_back(releasing_voices, p_voice);
+}
+
+void SynthVoicePool::free_voice(int p_voice) {
+	_detach(p_voice);
+	state[p_voice] = VOICE_FREE;
+	gain[p_voice] = 0.0f;
+	envelope_remaining[p_voice] = -1;
+	envelope_stage[p_voice] = ADSREnvelope::STAGE_IDLE;
+	_push_back(free_voices, p_voice);
+}
+
+// AudioStreamPlaybackSynth Implementation
+
+AudioStreamPlaybackSynth::AudioStreamPlaybackSynth() {
+	sample_rate = AudioServer::get_singleton()->get_mix_rate();
+	events.resize(EVENT_CAPACITY);
+	pool.reset();
+}
+
+AudioStreamPlaybackSynth::~AudioStreamPlaybackSynth() {
+}
+
+void AudioStreamPlaybackSynth::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("note_on", "note", "velocity"), &AudioStreamPlaybackSynth::note_on, DEFVAL(1.0f));
+	ClassDB::bind_method(D_METHOD("note_off", "note"), &AudioStreamPlaybackSynth::note_off);
+	ClassDB::bind_method(D_METHOD("all_notes_off"), &AudioStreamPlaybackSynth::all_notes_off);
+	ClassDB::bind_method(D_METHOD("get_active_voice_count"), &AudioStreamPlaybackSynth::get_active_voice_count);
+}
+
+void AudioStreamPlaybackSynth::set_stream(const Ref<AudioStreamSynth> &p_stream) {
+	stream = p_stream;
+}
+
+void AudioStreamPlaybackSynth::_push_event(const Event &p_event) {
+	if (events.write(&p_event, 1) == 0) {
+		WARN_PRINT("Synth event queue is full, event dropped.");
+	}
+}
+
+void AudioStreamPlaybackSynth::note_on(int p_note, float p_velocity) {
+	ERR_FAIL_INDEX(p_note, SynthVoicePool::NOTE_COUNT);
+
+	// MIDI convention: velocity 0 is a note-off
+	if (p_velocity <= 0.0f) {
+		note_off(p_note);
+		return;
+	}
+
+	Event event;
+	event.type = Event::NOTE_ON;
+	event.note = (uint8_t)p_note;
+	event.velocity = MIN(p_velocity, 1.0f);
+	event.frequency = 440.0f * std::pow(2.0f, (p_note - 69) / 12.0f);
+	_push_event(event);
+}
+
+void AudioStreamPlaybackSynth::note_off(int p_note) {
+	ERR_FAIL_INDEX(p_note, SynthVoicePool::NOTE_COUNT);
+
+	Event event;
+	event.type = Event::NOTE_OFF;
+	event.note = (uint8_t)p_note;
+	_push_event(event);
+}
+
+void AudioStreamPlaybackSynth::all_notes_off() {
+	Event event;
+	event.type = Event::ALL_NOTES_OFF;
+	_push_event(event);
+}
+
+int AudioStreamPlaybackSynth::get_active_voice_count() const {
+	return active_voice_count.load(std::memory_order_relaxed);
+}
+
+void AudioStreamPlaybackSynth::_start(double p_from_pos) {
+	// Queued events are kept, so notes sent just before play() still sound
+	pool.reset();
+	active_voice_count.store(0, std::memory_order_relaxed);
+
+	AudioStreamSynth::Params params;
+	if (stream.is_valid() && stream->read_params(params)) {
+		amplitude_ramp.reset(params.amplitude_linear);
+	}
+}
+
+void AudioStreamPlaybackSynth::_stop() {
+	// Nothing to do
+}
+
+bool AudioStreamPlaybackSynth::_is_playing() const {
+	return true; // Waits for notes like an instrument
+}
+
+int32_t AudioStreamPlaybackSynth::_get_loop_count() const {
+	return 0;
+}
+
+double AudioStreamPlaybackSynth::_get_playback_position() const {
+	return 0.0;
+}
+
+void AudioStreamPlaybackSynth::_seek(double p_time) {
+	// No seeking for a live instrument
+}
+
+void AudioStreamPlaybackSynth::_enter_stage(int p_voice, ADSREnvelope::Stage p_stage) {
+	ADSREnvelope::Stage stage = p_stage;
+	float value = pool.gain[p_voice];
+	ADSREnvelope::Segment segment = ADSREnvelope::enter(stage, value, pool.velocity[p_voice], envelope, (float)sample_rate);
+
+	pool.gain[p_voice] = value;
+	pool.envelope_stage[p_voice] = stage;
+	pool.envelope_mul[p_voice] = segment.mul;
+	pool.envelope_add[p_voice] = segment.add;
+	pool.envelope_min[p_voice] = segment.lo;
+	pool.envelope_max[p_voice] = segment.hi;
+	pool.envelope_end[p_voice] = segment.end;
+	pool.envelope_remaining[p_voice] = segment.length;
+}
+
+void AudioStreamPlaybackSynth::_release_voice(int p_voice) {
+	pool.release(p_voice);
+	_enter_stage(p_voice, ADSREnvelope::STAGE_RELEASE);
+}
+
+void AudioStreamPlaybackSynth::_note_on(const Event &p_event) {
+	// Retriggering a held note fades the previous voice out
+	int16_t previous = pool.note_voice[p_event.note];
+	if (previous != SynthVoicePool::NONE) {
+		_release_voice(previous);
+	}
+
+	bool stolen;
+	int voice = pool.allocate(steal_mode, polyphony, stolen);
+	if (voice == SynthVoicePool::NONE) {
+		return;
+	}
+
+	// A stolen voice keeps its phase and gain and glides into the new note, so there is no click
+	if (!stolen) {
+		pool.phase[voice] = 0;
+		pool.gain[voice] = 0.0f;
+	}
+	pool.frequency[voice] = p_event.frequency;
+	pool.hold(voice, p_event.note, p_event.velocity);
+	_enter_stage(voice, ADSREnvelope::STAGE_ATTACK);
+}
+
+void AudioStreamPlaybackSynth::_process_events() {
+	Event batch[EVENT_BATCH];
+	uint32_t count;
+	while ((count = events.read(batch, EVENT_BATCH)) > 0) {
+		for (uint32_t i = 0; i < count; i++) {
+			const Event &event = batch[i];
+			switch (event.type) {
+				case Event::NOTE_ON:
+					_note_on(event);
+					break;
+				case Event::NOTE_OFF: {
+					int16_t voice = pool.note_voice[event.note];
+					if (voice != SynthVoicePool::NONE) {
+						_release_voice(voice);
+					}
+				} break;
+				case Event::ALL_NOTES_OFF:
+					while (pool.held_voices.head != SynthVoicePool::NONE) {
+						_release_voice(pool.held_voices.head);
+					}
+					break;
+			}
+		}
+	}
+}
+
+void AudioStreamPlaybackSynth::_load_lane(OscKernels::VoiceGroup &r_group, int p_lane, int p_voice) const {
+	r_group.gain[p_lane] = pool.gain[p_voice];
+	r_group.gain_mul[p_lane] = pool.envelope_mul[p_voice];
+	r_group.gain_step[p_lane] = pool.envelope_add[p_voice];
+	r_group.gain_min[p_lane] = pool.envelope_min[p_voice];
+	r_group.gain_max[p_lane] = pool.envelope_max[p_voice];
+}
+
+void AudioStreamPlaybackSynth::_render_voices(float p_rate, float *p_mix, int p_count) {
+	// Snapshot the active voices first: a finished envelope frees its voice and changes the lists.
+	// Voices whose envelope is already silent are freed here instead of rendered.
+	int16_t active[SynthVoicePool::MAX_VOICES];
+	int active_count = 0;
+	for (int voice = pool.held_voices.head; voice != SynthVoicePool::NONE; voice = pool.next[voice]) {
+		active[active_count++] = (int16_t)voice;
+	}
+	for (int voice = pool.releasing_voices.head; voice != SynthVoicePool::NONE; voice = pool.next[voice]) {
+		active[active_count++] = (int16_t)voice;
+	}
+	int sounding = 0;
+	for (int i = 0; i < active_count; i++) {
+		if (pool.envelope_stage[active[i]] == ADSREnvelope::STAGE_IDLE) {
+			pool.free_voice(active[i]);
+		} else {
+			active[sounding++] = active[i];
+		}
+	}
+	active_count = sounding;
+
+	OscKernels::VoiceGroup group;
+	for (int first = 0; first < active_count; first += OscKernels::GROUP_SIZE) {
+		int lanes = MIN(OscKernels::GROUP_SIZE, active_count - first);
+
+		for (int lane = 0; lane < OscKernels::GROUP_SIZE; lane++) {
+			if (lane >= lanes) {
+				group.phase[lane] = 0;
+				group.increment[lane] = 0;
+				group.gain[lane] = 0.0f;
+				group.gain_mul[lane] = 1.0f;
+				group.gain_step[lane] = 0.0f;
+				group.gain_min[lane] = 0.0f;
+				group.gain_max[lane] = 0.0f;
+				continue;
+			}
+
+			int voice = active[first + lane];
+			group.phase[lane] = pool.phase[voice];
+			group.increment[lane] = OscKernels::phase_increment(pool.frequency[voice] * p_rate);
+			_load_lane(group, lane, voice);
+		}
+
+		// Render up to the first segment end among the lanes, move that voice to its next stage and
+		// continue: stage changes land on their exact sample, and most blocks need a single call
+		int done = 0;
+		while (done < p_count) {
+			int span = p_count - done;
+			for (int lane = 0; lane < lanes; lane++) {
+				int32_t remaining = pool.envelope_remaining[active[first + lane]];
+				if (remaining > 0 && remaining < span) {
+					span = remaining;
+				}
+			}
+
+			OscKernels::render_voices(shape, group, lanes, pulse_width, p_mix + done, span);
+			done += span;
+
+			for (int lane = 0; lane < lanes; lane++) {
+				int voice = active[first + lane];
+				if (pool.envelope_remaining[voice] <= 0) {
+					continue;
+				}
+				pool.envelope_remaining[voice] -= span;
+				if (pool.envelope_remaining[voice] == 0) {
+					pool.gain[voice] = pool.envelope_end[voice];
+					_enter_stage(voice, ADSREnvelope::next_stage((ADSREnvelope::Stage)pool.envelope_stage[voice]));
+					_load_lane(group, lane, voice);
+				}
+			}
+		}
+
+		for (int lane = 0; lane < lanes; lane++) {
+			int voice = active[first + lane];
+			pool.phase[voice] = group.phase[lane];
+			pool.gain[voice] = group.gain[lane];
+			if (pool.envelope_stage[voice] == ADSREnvelope::STAGE_IDLE) {
+				pool.free_voice(voice);
+			}
+		}
+	}
+}
+
+int AudioStreamPlaybackSynth::_mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) {
+	if (stream.is_null()) {
+		// Fill with silence if no stream
+		for (int32_t i = 0; i < p_frames; i++) {
+			p_buffer[i].left = 0.0f;
+			p_buffer[i].right = 0.0f;
+		}
+		return p_frames;
+	}
+
+	// One consistent parameter snapshot per block
+	AudioStreamSynth::Params params;
+	if (stream->read_params(params)) {
+		shape = AudioStreamOsc::get_kernel_shape(params.waveform_type, params.band_limited);
+		amplitude = params.amplitude_linear;
+		pulse_width = params.pulse_width;
+		envelope = params.envelope;
+		polyphony = params.polyphony;
+		steal_mode = (SynthVoicePool::StealMode)params.steal_mode;
+	}
+
+	_process_events();
+
+	float rate = p_rate_scale / sample_rate;
+	float master_step;
+	float master = amplitude_ramp.begin(amplitude, p_frames, master_step);
+
+	alignas(16) float mono[MIX_BLOCK_SIZE];
+	for (int32_t offset = 0; offset < p_frames; offset += MIX_BLOCK_SIZE) {
+		int32_t count = MIN(MIX_BLOCK_SIZE, p_frames - offset);
+		for (int32_t i = 0; i < count; i++) {
+			mono[i] = 0.0f;
+		}
+
+		_render_voices(rate, mono, count);
+
+		for (int32_t i = 0; i < count; i++) {
+			mono[i] *= master;
+			master += master_step;
+		}
+		OscKernels::splat_stereo(mono, (float *)(p_buffer + offset), count);
+	}
+
+	active_voice_count.store(pool.get_active_count(), std::memory_order_relaxed);
+	return p_frames;
+}
+
+void AudioStreamPlaybackSynth::_tag_used_streams() {
+	// No nested streams
+}
+
+// AudioStreamSynth Implementation
+
+AudioStreamSynth::AudioStreamSynth() {
+	// Leaves headroom for chords
+	set_amplitude_db(-12.0f);
+}
+
+AudioStreamSynth::~AudioStreamSynth() {
+}
+
+void AudioStreamSynth::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_waveform_type", "type"), &AudioStreamSynth::set_waveform_type);
+	ClassDB::bind_method(D_METHOD("get_waveform_type"), &AudioStreamSynth::get_waveform_type);
+
+	ClassDB::bind_method(D_METHOD("set_band_limited", "enabled"), &AudioStreamSynth::set_band_limited);
+	ClassDB::bind_method(D_METHOD("is_band_limited"), &AudioStreamSynth::is_band_limited);
+
+	ClassDB::bind_method(D_METHOD("set_pulse_width", "width"), &AudioStreamSynth::set_pulse_width);
+	ClassDB::bind_method(D_METHOD("get_pulse_width"), &AudioStreamSynth::get_pulse_width);
+
+	ClassDB::bind_method(D_METHOD("set_amplitude_db", "amplitude_db"), &AudioStreamSynth::set_amplitude_db);
+	ClassDB::bind_method(D_METHOD("get_amplitude_db"), &AudioStreamSynth::get_amplitude_db);
+
+	ClassDB::bind_method(D_METHOD("set_attack_time", "seconds"), &AudioStreamSynth::set_attack_time);
+	ClassDB::bind_method(D_METHOD("get_attack_time"), &AudioStreamSynth::get_attack_time);
+
+	ClassDB::bind_method(D_METHOD("set_decay_time", "seconds"), &AudioStreamSynth::set_decay_time);
+	ClassDB::bind_method(D_METHOD("get_decay_time"), &AudioStreamSynth::get_decay_time);
+
+	ClassDB::bind_method(D_METHOD("set_sustain_level", "level"), &AudioStreamSynth::set_sustain_level);
+	ClassDB::bind_method(D_METHOD("get_sustain_level"), &AudioStreamSynth::get_sustain_level);
+
+	ClassDB::bind_method(D_METHOD("set_release_time", "seconds"), &AudioStreamSynth::set_release_time);
+	ClassDB::bind_method(D_METHOD("get_release_time"), &AudioStreamSynth::get_release_time);
+
+	ClassDB::bind_method(D_METHOD("set_envelope_curve", "curve"), &AudioStreamSynth::set_envelope_curve);
+	ClassDB::bind_method(D_METHOD("get_envelope_curve"), &AudioStreamSynth::get_envelope_curve);
+
+	ClassDB::bind_method(D_METHOD("set_polyphony", "voices"), &AudioStreamSynth::set_polyphony);
+	ClassDB::bind_method(D_METHOD("get_polyphony"), &AudioStreamSynth::get_polyphony);
+
+	ClassDB::bind_method(D_METHOD("set_steal_mode", "mode"), &AudioStreamSynth::set_steal_mode);
+	ClassDB::bind_method(D_METHOD("get_steal_mode"), &AudioStreamSynth::get_steal_mode);
+
+	ClassDB::bind_static_method("AudioStreamSynth", D_METHOD("set_simd_level", "level"), &AudioStreamSynth::set_simd_level);
+	ClassDB::bind_static_method("AudioStreamSynth", D_METHOD("get_simd_level"), &AudioStreamSynth::get_simd_level);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "waveform_type", PROPERTY_HINT_ENUM, "Sine,Saw,Square,Triangle,Pulse"), "set_waveform_type", "get_waveform_type");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "band_limited"), "set_band_limited", "is_band_limited");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "pulse_width", PROPERTY_HINT_RANGE, "0.01,0.99,0.01"), "set_pulse_width", "get_pulse_width");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "amplitude_db", PROPERTY_HINT_RANGE, "-60.0,0.0,0.01,suffix:dB"), "set_amplitude_db", "get_amplitude_db");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "attack_time", PROPERTY_HINT_RANGE, "0.001,5.0,0.001,suffix:s"), "set_attack_time", "get_attack_time");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "decay_time", PROPERTY_HINT_RANGE, "0.0,10.0,0.001,suffix:s"), "set_decay_time", "get_decay_time");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "sustain_level", PROPERTY_HINT_RANGE, "0.0,1.0,0.01"), "set_sustain_level", "get_sustain_level");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "release_time", PROPERTY_HINT_RANGE, "0.001,10.0,0.001,suffix:s"), "set_release_time", "get_release_time");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "envelope_curve", PROPERTY_HINT_ENUM, "Linear,Exponential"), "set_envelope_curve", "get_envelope_curve");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "polyphony", PROPERTY_HINT_RANGE, "1,128,1"), "set_polyphony", "get_polyphony");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "steal_mode", PROPERTY_HINT_ENUM, "Oldest,Quietest"), "set_steal_mode", "get_steal_mode");
+
+	BIND_ENUM_CONSTANT(STEAL_OLDEST);
+	BIND_ENUM_CONSTANT(STEAL_QUIETEST);
+
+	BIND_ENUM_CONSTANT(SIMD_SCALAR);
+	BIND_ENUM_CONSTANT(SIMD_SSE2);
+	BIND_ENUM_CONSTANT(SIMD_AVX2);
+}
+
+void AudioStreamSynth::set_waveform_type(AudioStreamOsc::WaveformType p_type) {
+	// Voices are rendered as phase-stepped kernel lanes, which noise does not have
+	ERR_FAIL_COND_MSG(AudioStreamOsc::is_noise(p_type), "Noise waveforms are only available on AudioStreamOsc.");
+	params.edit().waveform_type = p_type;
+	params.publish();
+}
+
+AudioStreamOsc::WaveformType AudioStreamSynth::get_waveform_type() const {
+	return params.get().waveform_type;
+}
+
+void AudioStreamSynth::set_band_limited(bool p_enabled) {
+	params.edit().band_limited = p_enabled;
+	params.publish();
+}
+
+bool AudioStreamSynth::is_band_limited() const {
+	return params.get().band_limited;
+}
+
+void AudioStreamSynth::set_pulse_width(float p_width) {
+	params.edit().pulse_width = CLAMP(p_width, 0.01f, 0.99f);
+	params.publish();
+}
+
+float AudioStreamSynth::get_pulse_width() const {
+	return params.get().pulse_width;
+}
+
+void AudioStreamSynth::set_amplitude_db(float p_amplitude_db) {
+	Params &edit = params.edit();
+	edit.amplitude_db = CLAMP(p_amplitude_db, -60.0f, 0.0f);
+	edit.amplitude_linear = std::pow(10.0f, edit.amplitude_db / 20.0f);
+	params.publish();
+}
+
+float AudioStreamSynth::get_amplitude_db() const {
+	return params.get().amplitude_db;
+}
+
+void AudioStreamSynth::set_attack_time(float p_seconds) {
+	params.edit().envelope.attack = CLAMP(p_seconds, 0.001f, 5.0f);
+	params.publish();
+}
+
+float AudioStreamSynth::get_attack_time() const {
+	return params.get().envelope.attack;
+}
+
+void AudioStreamSynth::set_decay_time(float p_seconds) {
+	params.edit().envelope.decay = CLAMP(p_seconds, 0.0f, 10.0f);
+	params.publish();
+}
+
+float AudioStreamSynth::get_decay_time() const {
+	return params.get().envelope.decay;
+}
+
+void AudioStreamSynth::set_sustain_level(float p_level) {
+	params.edit().envelope.sustain = CLAMP(p_level, 0.0f, 1.0f);
+	params.publish();
+}
+
+float AudioStreamSynth::get_sustain_level() const {
+	return params.get().envelope.sustain;
+}
+
+void AudioStreamSynth::set_release_time(float p_seconds) {
+	params.edit().envelope.release = CLAMP(p_seconds, 0.001f, 10.0f);
+	params.publish();
+}
+
+float AudioStreamSynth::get_release_time() const {
+	return params.get().envelope.release;
+}
+
+void AudioStreamSynth::set_envelope_curve(AudioStreamOsc::EnvelopeCurve p_curve) {
+	params.edit().envelope.curve = (ADSREnvelope::Curve)p_curve;
+	params.publish();
+}
+
+AudioStreamOsc::EnvelopeCurve AudioStreamSynth::get_envelope_curve() const {
+	return (AudioStreamOsc::EnvelopeCurve)params.get().envelope.curve;
+}
+
+void AudioStreamSynth::set_polyphony(int p_voices) {
+	params.edit().polyphony = CLAMP(p_voices, 1, SynthVoicePool::MAX_VOICES);
+	params.publish();
+}
+
+int AudioStreamSynth::get_polyphony() const {
+	return params.get().polyphony;
+}
+
+void AudioStreamSynth::set_steal_mode(StealMode p_mode) {
+	params.edit().steal_mode = p_mode;
+	params.publish();
+}
+
+AudioStreamSynth::StealMode AudioStreamSynth::get_steal_mode() const {
+	return params.get().steal_mode;
+}
+
+void AudioStreamSynth::set_simd_level(SimdLevel p_level) {
+	OscKernels::set_simd_level((OscKernels::SimdLevel)p_level);
+}
+
+AudioStreamSynth::SimdLevel AudioStreamSynth::get_simd_level() {
+	return (SimdLevel)OscKernels::get_simd_level();
+}
+
+Ref<AudioStreamPlayback> AudioStreamSynth::_instantiate_playback() const {
+	Ref<AudioStreamPlaybackSynth> playback;
+	playback.instantiate();
+	playback->set_stream(Ref<AudioStreamSynth>(this));
+	return playback;
+}
+
+String AudioStreamSynth::_get_stream_name() const {
+	return "Synth";
+}
+
+double AudioStreamSynth::_get_length() const {
+	return 0.0; // Infinite stream
+}
+
+bool AudioStreamSynth::_is_monophonic() const {
+	return true; // One playback renders every voice
+}
+
+double AudioStreamSynth::_get_bpm() const {
+	return 0.0;
+}
+
+int32_t AudioStreamSynth::_get_beat_count() const {
+	return 0;
+}
@@ -0,0 +1,270 @@
+/**************************************************************************/
+/*  audio_stream_synth.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef AUDIO_STREAM_SYNTH_H
+#define AUDIO_STREAM_SYNTH_H
+
+#include <godot_cpp/classes/audio_stream.hpp>
+#include <godot_cpp/classes/audio_stream_playback.hpp>
+#include <godot_cpp/classes/audio_server.hpp>
+
+#include "adsr_envelope.h"
+#include "audio_stream_osc.h"
+#include "osc_kernels.h"
+#include "param_snapshot.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <cstdint>
+
+using namespace godot;
+
+class AudioStreamSynth;
+
+// Fixed pool of voices stored as structure-of-arrays. Every voice sits in exactly one of the
+// free / held / releasing lists (intrusive, linked by index), and held voices are also linked into
+// one list per velocity bucket. Allocation, release and stealing are list operations: no searches.
+struct SynthVoicePool {
+	static constexpr int MAX_VOICES = 128;
+	static constexpr int NOTE_COUNT = 128;
+	static constexpr int VELOCITY_BUCKETS = 16;
+	static constexpr int16_t NONE = -1;
+
+	enum VoiceState : uint8_t {
+		VOICE_FREE,
+		VOICE_HELD,
+		VOICE_RELEASING,
+	};
+
+	enum StealMode {
+		STEAL_OLDEST,
+		STEAL_QUIETEST,
+	};
+
+	struct List {
+		int16_t head = NONE;
+		int16_t tail = NONE;
+		int count = 0;
+	};
+
+	// Per-voice render state
+	uint32_t phase[MAX_VOICES]; // OscKernels fixed point
+	float frequency[MAX_VOICES];
+	float gain[MAX_VOICES]; // Current envelope value (velocity scaled)
+	float velocity[MAX_VOICES];
+
+	// Envelope segment of each voice, in VoiceGroup gain terms
+	float envelope_mul[MAX_VOICES];
+	float envelope_add[MAX_VOICES];
+	float envelope_min[MAX_VOICES];
+	float envelope_max[MAX_VOICES];
+	float envelope_end[MAX_VOICES];
+	int32_t envelope_remaining[MAX_VOICES]; // Samples to the next stage, -1 while sustaining
+	uint8_t envelope_stage[MAX_VOICES]; // ADSREnvelope::Stage
+	uint8_t note[MAX_VOICES];
+	uint8_t state[MAX_VOICES];
+
+	// List links
+	int16_t prev[MAX_VOICES];
+	int16_t next[MAX_VOICES];
+	int16_t bucket_prev[MAX_VOICES];
+	int16_t bucket_next[MAX_VOICES];
+
+	List free_voices;
+	List held_voices; // Note-on order, head is the oldest
+	List releasing_voices; // Note-off order, head has been fading the longest
+	List velocity_buckets[VELOCITY_BUCKETS]; // Held voices by velocity, bucket 0 is the quietest
+
+	int16_t note_voice[NOTE_COUNT]; // Held voice playing each note
+
+	void reset();
+
+	int get_active_count() const { return held_voices.count + releasing_voices.count; }
+
+	// Returns a voice ready to start (out of every list); steals one once p_polyphony voices are active
+	int allocate(StealMode p_mode, int p_polyphony, bool &r_stolen);
+
+	// State changes; each moves the voice to the matching list
+	void hold(int p_voice, int p_note, float p_velocity);
+	void release(int p_voice);
+	void free_voice(int p_voice);
+
+private:
+	List &_list_for(uint8_t p_state);
+	static int _bucket_for(float p_velocity);
+
+	void _push_back(List &r_list, int p_voice);
+	void _remove(List &r_list, int p_voice);
+	void _bucket_push_back(int p_bucket, int p_voice);
+	void _bucket_remove(int p_bucket, int p_voice);
+	void _detach(int p_voice);
+};
+
+class AudioStreamPlaybackSynth : public AudioStreamPlayback {
+	GDCLASS(AudioStreamPlaybackSynth, AudioStreamPlayback)
+
+public:
+	// Game thread -> audio thread
+	struct Event {
+		enum Type : uint8_t {
+			NOTE_ON,
+			NOTE_OFF,
+			ALL_NOTES_OFF,
+		};
+		Type type = NOTE_ON;
+		uint8_t note = 0;
+		float velocity = 0.0f;
+		float frequency = 0.0f; // Computed on the sending side
+	};
+
+	static constexpr int EVENT_CAPACITY = 1024;
+
+private:
+	Ref<AudioStreamSynth> stream;
+	double sample_rate = 44100.0;
+
+	SPSCRing<Event> events;
+	SynthVoicePool pool;
+	std::atomic<int> active_voice_count{ 0 };
+
+	// Last parameter snapshot, kept when a read overlaps a write
+	OscKernels::Shape shape = OscKernels::SHAPE_SINE;
+	float amplitude = 0.0f;
+	float pulse_width = 0.5f;
+	ADSREnvelope::Settings envelope;
+	int polyphony = SynthVoicePool::MAX_VOICES;
+	SynthVoicePool::StealMode steal_mode = SynthVoicePool::STEAL_OLDEST;
+	ParamRamp amplitude_ramp;
+
+	void _push_event(const Event &p_event);
+	void _process_events();
+	void _note_on(const Event &p_event);
+	void _release_voice(int p_voice);
+	void _enter_stage(int p_voice, ADSREnvelope::Stage p_stage);
+	void _load_lane(OscKernels::VoiceGroup &r_group, int p_lane, int p_voice) const;
+	void _render_voices(float p_rate, float *p_mix, int p_count);
+
+protected:
+	static void _bind_methods();
+
+public:
+	AudioStreamPlaybackSynth();
+	~AudioStreamPlaybackSynth();
+
+	void set_stream(const Ref<AudioStreamSynth> &p_stream);
+
+	// Game thread; events are queued and applied at the start of the next mix block.
+	// Calls must come from one thread at a time.
+	void note_on(int p_note, float p_velocity = 1.0f);
+	void note_off(int p_note);
+	void all_notes_off();
+
+	int get_active_voice_count() const;
+
+	virtual void _start(double p_from_pos = 0.0) override;
+	virtual void _stop() override;
+	virtual bool _is_playing() const override;
+	virtual int32_t _get_loop_count() const override;
+	virtual double _get_playback_position() const override;
+	virtual void _seek(double p_time) override;
+	virtual int _mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) override;
+	virtual void _tag_used_streams() override;
+};
+
+class AudioStreamSynth : public AudioStream {
+	GDCLASS(AudioStreamSynth, AudioStream)
+
+public:
+	enum StealMode {
+		STEAL_OLDEST = SynthVoicePool::STEAL_OLDEST,
+		STEAL_QUIETEST = SynthVoicePool::STEAL_QUIETEST,
+	};
+
+	enum SimdLevel {
+		SIMD_SCALAR = OscKernels::SIMD_SCALAR,
+		SIMD_SSE2 = OscKernels::SIMD_SSE2,
+		SIMD_AVX2 = OscKernels::SIMD_AVX2,
+	};
+
+	// Everything the playback reads on the audio thread
+	struct Params {
+		AudioStreamOsc::WaveformType waveform_type = AudioStreamOsc::WAVEFORM_SAW;
+		bool band_limited = true;
+		float pulse_width = 0.5f;
+		float amplitude_db = -12.0f;
+		float amplitude_linear = 0.25f;
+		ADSREnvelope::Settings envelope;
+		int polyphony = SynthVoicePool::MAX_VOICES;
+		StealMode steal_mode = STEAL_OLDEST;
+	};
+
+private:
+	ParamSnapshot<Params> params;
+
+protected:
+	static void _bind_methods();
+
+public:
+	AudioStreamSynth();
+	~AudioStreamSynth();
+
+	void set_waveform_type(AudioStreamOsc::WaveformType p_type);
+	AudioStreamOsc::WaveformType get_waveform_type() const;
+
+	void set_band_limited(bool p_enabled);
+	bool is_band_limited() const;
+
+	void set_pulse_width(float p_width);
+	float get_pulse_width() const;
+
+	void set_amplitude_db(float p_amplitude_db);
+	float get_amplitude_db() const;
+
+	void set_attack_time(float p_seconds);
+	float get_attack_time() const;
+
+	void set_decay_time(float p_seconds);
+	float get_decay_time() const;
+
+	// Fraction of the note's velocity held until note-off
+	void set_sustain_level(float p_level);
+	float get_sustain_level() const;
+
+	void set_release_time(float p_seconds);
+	float get_release_time() const;
+
+	void set_envelope_curve(AudioStreamOsc::EnvelopeCurve p_curve);
+	AudioStreamOsc::EnvelopeCurve get_envelope_curve() const;
+
+	void set_polyphony(int p_voices);
+	int get_polyphony() const;
+
+	void set_steal_mode(StealMode p_mode);
+	StealMode get_steal_mode() const;
+
+	// Instruction set of the voice kernels, for every synth and unison oscillator in the process.
+	// Starts at the best the CPU supports; lowering it is meant for benchmarks, and it cannot be
+	// raised above what the CPU supports.
+	static void set_simd_level(SimdLevel p_level);
+	static SimdLevel get_simd_level();
+
+	// Audio thread: consistent copy of the parameters; false keeps r_params unchanged
+	bool read_params(Params &r_params) const { return params.read(r_params); }
+
+	virtual Ref<AudioStreamPlayback> _instantiate_playback() const override;
+	virtual String _get_stream_name() const override;
+	virtual double _get_length() const override;
+	virtual bool _is_monophonic() const override;
+	virtual double _get_bpm() const override;
+	virtual int32_t _get_beat_count() const override;
+};
+
+VARIANT_ENUM_CAST(AudioStreamSynth::StealMode);
+VARIANT_ENUM_CAST(AudioStreamSynth::SimdLevel);
+
+#endif // AUDIO_STREAM_SYNTH_H
@@ -0,0 +1,427 @@
+/**************************************************************************/
+/*  audio_stream_wavetable.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "audio_stream_wavetable.h"
+#include "fft_processor.h"
+#include "pffft.h"
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+// Samples rendered per kernel call; the mono scratch lives on the stack
+static const int MIX_BLOCK_SIZE = 256;
+
+// 1 ms waits for readers of replaced tables before the build task leaves them to the next request
+static const int RETIRE_ATTEMPTS = 20;
+
+// AudioStreamPlaybackWavetable Implementation
+
+AudioStreamPlaybackWavetable::AudioStreamPlaybackWavetable() {
+	phase = 0;
+	sample_rate = AudioServer::get_singleton()->get_mix_rate();
+}
+
+AudioStreamPlaybackWavetable::~AudioStreamPlaybackWavetable() {
+}
+
+void AudioStreamPlaybackWavetable::_bind_methods() {
+}
+
+void AudioStreamPlaybackWavetable::set_stream(const Ref<AudioStreamWavetable> &p_stream) {
+	stream = p_stream;
+}
+
+void AudioStreamPlaybackWavetable::_start(double p_from_pos) {
+	phase = 0;
+
+	AudioStreamWavetable::Params params;
+	if (stream.is_valid() && stream->read_params(params)) {
+		amplitude_ramp.reset(params.amplitude_linear);
+		morph_ramp.reset(params.morph);
+	}
+}
+
+void AudioStreamPlaybackWavetable::_stop() {
+	// Nothing to do
+}
+
+bool AudioStreamPlaybackWavetable::_is_playing() const {
+	return true; // Continuous like AudioStreamOsc
+}
+
+int32_t AudioStreamPlaybackWavetable::_get_loop_count() const {
+	return 0;
+}
+
+double AudioStreamPlaybackWavetable::_get_playback_position() const {
+	return 0.0;
+}
+
+void AudioStreamPlaybackWavetable::_seek(double p_time) {
+	// No seeking for a continuous oscillator
+}
+
+int AudioStreamPlaybackWavetable::_mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) {
+	// Tables are still being built on the first blocks after load
+	const WavetableTables *tables = stream.is_valid() ? stream->acquire_tables() : nullptr;
+	if (tables == nullptr) {
+		if (stream.is_valid()) {
+			stream->release_tables();
+		}
+		for (int32_t i = 0; i < p_frames; i++) {
+			p_buffer[i].left = 0.0f;
+			p_buffer[i].right = 0.0f;
+		}
+		return p_frames;
+	}
+
+	AudioStreamWavetable::Params params;
+	if (stream->read_params(params)) {
+		frequency = params.frequency;
+		amplitude = params.amplitude_linear;
+		morph = params.morph;
+	}
+
+	double increment = frequency * p_rate_scale / sample_rate;
+	OscKernels::State state;
+	state.phase = phase;
+	state.increment = OscKernels::phase_increment_64(increment);
+	state.amplitude = amplitude_ramp.begin(amplitude, p_frames, state.amplitude_step);
+
+	// The morph position ramps across the block like the amplitude. The mip level is fixed for the
+	// block; the pair of frames changes wherever the position crosses a frame
+	int mip = tables->select_mip(increment);
+	int last_frame = tables->frame_count - 1;
+	float position_step;
+	float position = morph_ramp.begin(morph, p_frames, position_step) * last_frame;
+	position_step *= last_frame;
+
+	alignas(16) float mono[MIX_BLOCK_SIZE];
+	int32_t offset = 0;
+	while (offset < p_frames) {
+		int32_t count = MIN(MIX_BLOCK_SIZE, p_frames - offset);
+
+		// Frame A is the one below the position, or below the next crossing when moving down, so
+		// the crossfade runs from 0 to 1 within each span
+		int frame_a = position_step < 0.0f ? (int)ceilf(position) - 1 : (int)position;
+		frame_a = CLAMP(frame_a, 0, MAX(last_frame - 1, 0));
+		float fraction = position - frame_a;
+		if (position_step > 0.0f && frame_a + 1 < last_frame) {
+			count = MIN(count, (int32_t)((1.0f - fraction) / position_step) + 1);
+		} else if (position_step < 0.0f && frame_a > 0) {
+			count = MIN(count, (int32_t)(fraction / -position_step) + 1);
+		}
+
+		const float *table_a = tables->get_table(frame_a, mip);
+		const float *table_b = tables->get_table(MIN(frame_a + 1, last_frame), mip);
+		OscKernels::render_wavetable(table_a, table_b, fraction, position_step, tables->table_size, mono, count, state);
+		OscKernels::splat_stereo(mono, (float *)(p_buffer + offset), count);
+
+		offset += count;
+		position += count * position_step;
+	}
+
+	phase = state.phase;
+	stream->release_tables();
+	return p_frames;
+}
+
+void AudioStreamPlaybackWavetable::_tag_used_streams() {
+	// No nested streams
+}
+
+// AudioStreamWavetable Implementation
+
+AudioStreamWavetable::AudioStreamWavetable() {
+	set_amplitude_db(-6.0f);
+}
+
+AudioStreamWavetable::~AudioStreamWavetable() {
+	if (build_task >= 0) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(build_task);
+		build_task = -1;
+	}
+
+	delete tables.exchange(nullptr);
+	for (const WavetableTables *old : retired_tables) {
+		delete old;
+	}
+}
+
+void AudioStreamWavetable::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_frame_size", "size"), &AudioStreamWavetable::set_frame_size);
+	ClassDB::bind_method(D_METHOD("get_frame_size"), &AudioStreamWavetable::get_frame_size);
+
+	ClassDB::bind_method(D_METHOD("set_frames", "frames"), &AudioStreamWavetable::set_frames);
+	ClassDB::bind_method(D_METHOD("get_frames"), &AudioStreamWavetable::get_frames);
+
+	ClassDB::bind_method(D_METHOD("set_frequency", "frequency"), &AudioStreamWavetable::set_frequency);
+	ClassDB::bind_method(D_METHOD("get_frequency"), &AudioStreamWavetable::get_frequency);
+
+	ClassDB::bind_method(D_METHOD("set_amplitude_db", "amplitude_db"), &AudioStreamWavetable::set_amplitude_db);
+	ClassDB::bind_method(D_METHOD("get_amplitude_db"), &AudioStreamWavetable::get_amplitude_db);
+
+	ClassDB::bind_method(D_METHOD("set_morph", "morph"), &AudioStreamWavetable::set_morph);
+	ClassDB::bind_method(D_METHOD("get_morph"), &AudioStreamWavetable::get_morph);
+
+	ClassDB::bind_method(D_METHOD("get_frame_count"), &AudioStreamWavetable::get_frame_count);
+	ClassDB::bind_method(D_METHOD("get_mip_count"), &AudioStreamWavetable::get_mip_count);
+	ClassDB::bind_method(D_METHOD("is_ready"), &AudioStreamWavetable::is_ready);
+
+	// frame_size comes first so loading a resource builds the tables once, with the right size
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "frame_size", PROPERTY_HINT_ENUM, "256:256,512:512,1024:1024,2048:2048,4096:4096"), "set_frame_size", "get_frame_size");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "frames", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR), "set_frames", "get_frames");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "frequency", PROPERTY_HINT_RANGE, "20.0,20000.0,0.01,suffix:Hz"), "set_frequency", "get_frequency");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "amplitude_db", PROPERTY_HINT_RANGE, "-60.0,0.0,0.01,suffix:dB"), "set_amplitude_db", "get_amplitude_db");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "morph", PROPERTY_HINT_RANGE, "0.0,1.0,0.001"), "set_morph", "get_morph");
+}
+
+void AudioStreamWavetable::set_frames(const PackedFloat32Array &p_frames) {
+	frames = p_frames;
+	_request_build();
+}
+
+PackedFloat32Array AudioStreamWavetable::get_frames() const {
+	return frames;
+}
+
+void AudioStreamWavetable::set_frame_size(int p_size) {
+	ERR_FAIL_COND_MSG(!FFTProcessor::is_valid_fft_size(p_size), "Frame size must be a valid FFT size.");
+	if (p_size == frame_size) {
+		return;
+	}
+	frame_size = p_size;
+	_request_build();
+}
+
+int AudioStreamWavetable::get_frame_size() const {
+	return frame_size;
+}
+
+void AudioStreamWavetable::set_frequency(float p_frequency) {
+	params.edit().frequency = CLAMP(p_frequency, 20.0f, 20000.0f);
+	params.publish();
+}
+
+float AudioStreamWavetable::get_frequency() const {
+	return params.get().frequency;
+}
+
+void AudioStreamWavetable::set_amplitude_db(float p_amplitude_db) {
+	Params &edit = params.edit();
+	edit.amplitude_db = CLAMP(p_amplitude_db, -60.0f, 0.0f);
+	edit.amplitude_linear = std::pow(10.0f, edit.amplitude_db / 20.0f);
+	params.publish();
+}
+
+float AudioStreamWavetable::get_amplitude_db() const {
+	return params.get().amplitude_db;
+}
+
+void AudioStreamWavetable::set_morph(float p_morph) {
+	params.edit().morph = CLAMP(p_morph, 0.0f, 1.0f);
+	params.publish();
+}
+
+float AudioStreamWavetable::get_morph() const {
+	return params.get().morph;
+}
+
+int AudioStreamWavetable::get_frame_count() const {
+	return frame_size > 0 ? (int)(frames.size() / frame_size) : 0;
+}
+
+int AudioStreamWavetable::get_mip_count() const {
+	const WavetableTables *current = acquire_tables();
+	int count = current != nullptr ? current->mip_count : 0;
+	release_tables();
+	return count;
+}
+
+bool AudioStreamWavetable::is_ready() const {
+	return tables.load(std::memory_order_acquire) != nullptr;
+}
+
+void AudioStreamWavetable::_request_build() {
+	if (frames.size() % frame_size != 0) {
+		WARN_PRINT("Wavetable frames are not a multiple of frame_size, the last partial frame is ignored.");
+	}
+
+	std::lock_guard<std::mutex> lock(build_mutex);
+	_collect_retired_tables();
+
+	// A request that has not started yet is simply replaced
+	build_frames = frames;
+	build_frame_size = frame_size;
+	build_pending = true;
+
+	if (build_running) {
+		return; // The running task picks the request up when it finishes the current one
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (build_task >= 0) {
+		pool->wait_for_task_completion(build_task); // Already done, this only releases it
+	}
+	build_running = true;
+	build_task = pool->add_native_task(&AudioStreamWavetable::_build_task, this, false, "Build wavetable mips");
+}
+
+void AudioStreamWavetable::_build_task(void *p_userdata) {
+	AudioStreamWavetable *stream = (AudioStreamWavetable *)p_userdata;
+
+	while (true) {
+		PackedFloat32Array source;
+		int size;
+		{
+			std::lock_guard<std::mutex> lock(stream->build_mutex);
+			if (!stream->build_pending) {
+				stream->build_running = false;
+				return;
+			}
+			source = stream->build_frames;
+			size = stream->build_frame_size;
+			stream->build_pending = false;
+		}
+
+		// Fewer samples than one frame publishes nothing, the current tables keep playing
+		WavetableTables *built = _build_tables(source, size);
+		if (built == nullptr) {
+			continue;
+		}
+
+		// Playbacks may still be reading the previous tables. A _mix() holds them for well under a
+		// millisecond, so a few short waits normally free them here; anything left over is freed by
+		// the next build request or the destructor.
+		const WavetableTables *previous = stream->tables.exchange(built, std::memory_order_seq_cst);
+		if (previous == nullptr) {
+			continue;
+		}
+		{
+			std::lock_guard<std::mutex> lock(stream->build_mutex);
+			stream->retired_tables.push_back(previous);
+		}
+		for (int attempt = 0; attempt < RETIRE_ATTEMPTS; attempt++) {
+			{
+				std::lock_guard<std::mutex> lock(stream->build_mutex);
+				if (stream->_collect_retired_tables()) {
+					break;
+				}
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
+
+bool AudioStreamWavetable::_collect_retired_tables() {
+	if (retired_tables.empty()) {
+		return true;
+	}
+	// Every set in the list was replaced before this load, so a reader that comes in later gets
+	// the current tables; zero readers now means nobody holds a retired set
+	if (table_readers.load(std::memory_order_seq_cst) != 0) {
+		return false;
+	}
+	for (const WavetableTables *old : retired_tables) {
+		delete old;
+	}
+	retired_tables.clear();
+	return true;
+}
+
+WavetableTables *AudioStreamWavetable::_build_tables(const PackedFloat32Array &p_frames, int p_frame_size) {
+	int frame_count = (int)(p_frames.size() / p_frame_size);
+	if (frame_count == 0) {
+		return nullptr;
+	}
+
+	WavetableTables *result = new WavetableTables;
+	result->table_size = p_frame_size;
+	result->frame_count = frame_count;
+	result->stride = p_frame_size + 2;
+	result->mip_count = 0;
+	for (int harmonics = p_frame_size / 2; harmonics >= 1; harmonics >>= 1) {
+		result->mip_count++;
+	}
+	result->samples.resize((size_t)frame_count * result->mip_count * result->stride);
+
+	// Frames are built one after another: this already runs on a low-priority pool task, and
+	// waiting there for more low-priority tasks can deadlock pools with a single low-priority slot
+	Ref<FFTProcessor> fft;
+	fft.instantiate();
+	fft->setup_fft(p_frame_size);
+	float *scratch = (float *)pffft_aligned_malloc(3 * p_frame_size * sizeof(float));
+
+	for (int f = 0; f < frame_count; f++) {
+		_build_frame(result, f, p_frames.ptr() + (size_t)f * p_frame_size, fft.ptr(), scratch);
+	}
+
+	pffft_aligned_free(scratch);
+	return result;
+}
+
+void AudioStreamWavetable::_build_frame(WavetableTables *r_tables, int p_frame, const float *p_source, FFTProcessor *p_fft, float *r_scratch) {
+	const int size = r_tables->table_size;
+
+	// Three aligned blocks of size samples
+	float *time = r_scratch;
+	float *spectrum = r_scratch + size;
+	float *filtered = r_scratch + 2 * size;
+
+	memcpy(time, p_source, size * sizeof(float));
+	p_fft->transform_ordered(time, spectrum, FFTProcessor::FORWARD);
+
+	// Ordered layout is [DC, Nyquist, Re(1), Im(1), ...]; level m keeps bins 1 .. (N/2 >> m)
+	const float scale = 1.0f / size;
+	for (int mip = 0; mip < r_tables->mip_count; mip++) {
+		int harmonics = (size / 2) >> mip;
+		memcpy(filtered, spectrum, size * sizeof(float));
+		filtered[1] = 0.0f; // Nyquist never survives, its phase is ambiguous
+		int keep = MIN(harmonics, size / 2 - 1);
+		memset(filtered + 2 + keep * 2, 0, (size - 2 - keep * 2) * sizeof(float));
+
+		p_fft->transform_ordered(filtered, time, FFTProcessor::INVERSE);
+
+		float *table = (float *)r_tables->get_table(p_frame, mip);
+		for (int i = 0; i < size; i++) {
+			table[i] = time[i] * scale;
+		}
+		table[size] = table[0];
+		table[size + 1] = table[1];
+	}
+}
+
+Ref<AudioStreamPlayback> AudioStreamWavetable::_instantiate_playback() const {
+	Ref<AudioStreamPlaybackWavetable> playback;
+	playback.instantiate();
+	playback->set_stream(Ref<AudioStreamWavetable>(this));
+	return playback;
+}
+
+String AudioStreamWavetable::_get_stream_name() const {
+	return "Wavetable";
+}
+
+double AudioStreamWavetable::_get_length() const {
+	return 0.0; // Infinite stream
+}
+
+bool AudioStreamWavetable::_is_monophonic() const {
+	return true;
+}
+
+double AudioStreamWavetable::_get_bpm() const {
+	return 0.0;
+}
+
+int32_t AudioStreamWavetable::_get_beat_count() const {
+	return 0;
+}
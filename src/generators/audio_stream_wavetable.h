@@ -0,0 +1,176 @@
+/**************************************************************************/
+/*  audio_stream_wavetable.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef AUDIO_STREAM_WAVETABLE_H
+#define AUDIO_STREAM_WAVETABLE_H
+
+#include <godot_cpp/classes/audio_stream.hpp>
+#include <godot_cpp/classes/audio_stream_playback.hpp>
+#include <godot_cpp/classes/audio_server.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+
+#include "osc_kernels.h"
+#include "param_snapshot.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace godot;
+
+class AudioStreamWavetable;
+class FFTProcessor;
+
+// Band-limited tables for every source frame, one mip level per octave: level m keeps
+// table_size / 2 >> m harmonics. Built once off the audio thread and never modified afterwards,
+// so every playback of the stream reads the same memory without synchronization.
+struct WavetableTables {
+	int table_size = 0;
+	int frame_count = 0;
+	int mip_count = 0;
+	int stride = 0; // table_size + 2 guard samples
+	std::vector<float> samples; // [frame][mip][stride]
+
+	const float *get_table(int p_frame, int p_mip) const {
+		return samples.data() + ((size_t)p_frame * mip_count + p_mip) * stride;
+	}
+
+	// Lowest level whose top harmonic stays below Nyquist at this phase increment
+	int select_mip(double p_increment) const {
+		int mip = 0;
+		int harmonics = table_size / 2;
+		while (mip < mip_count - 1 && harmonics * p_increment > 0.5) {
+			harmonics >>= 1;
+			mip++;
+		}
+		return mip;
+	}
+};
+
+class AudioStreamPlaybackWavetable : public AudioStreamPlayback {
+	GDCLASS(AudioStreamPlaybackWavetable, AudioStreamPlayback)
+
+private:
+	Ref<AudioStreamWavetable> stream;
+	uint64_t phase = 0; // OscKernels::State fixed point
+	double sample_rate = 44100.0;
+
+	// Last parameter snapshot, kept when a read overlaps a write
+	float frequency = 440.0f;
+	float amplitude = 0.0f;
+	float morph = 0.0f;
+	ParamRamp amplitude_ramp;
+	ParamRamp morph_ramp;
+
+protected:
+	static void _bind_methods();
+
+public:
+	AudioStreamPlaybackWavetable();
+	~AudioStreamPlaybackWavetable();
+
+	void set_stream(const Ref<AudioStreamWavetable> &p_stream);
+
+	virtual void _start(double p_from_pos = 0.0) override;
+	virtual void _stop() override;
+	virtual bool _is_playing() const override;
+	virtual int32_t _get_loop_count() const override;
+	virtual double _get_playback_position() const override;
+	virtual void _seek(double p_time) override;
+	virtual int _mix(AudioFrame *p_buffer, float p_rate_scale, int p_frames) override;
+	virtual void _tag_used_streams() override;
+};
+
+class AudioStreamWavetable : public AudioStream {
+	GDCLASS(AudioStreamWavetable, AudioStream)
+
+public:
+	// Everything the playbacks read on the audio thread
+	struct Params {
+		float frequency = 440.0f;
+		float amplitude_db = -6.0f;
+		float amplitude_linear = 0.5f;
+		float morph = 0.0f;
+	};
+
+private:
+	ParamSnapshot<Params> params;
+
+	// Source data (saved with the resource)
+	PackedFloat32Array frames;
+	int frame_size = 2048;
+
+	// Published tables. Every access is counted in table_readers (acquire_tables()); a replaced set
+	// waits in retired_tables until the count has been seen at zero after the swap.
+	std::atomic<const WavetableTables *> tables{ nullptr };
+	mutable std::atomic<int> table_readers{ 0 };
+	std::vector<const WavetableTables *> retired_tables; // build_mutex
+
+	// Main thread -> build task
+	std::mutex build_mutex;
+	PackedFloat32Array build_frames;
+	int build_frame_size = 0;
+	bool build_pending = false;
+	bool build_running = false;
+	int64_t build_task = -1;
+
+	void _request_build();
+	bool _collect_retired_tables(); // Called with build_mutex held; true once none are left
+	static void _build_task(void *p_userdata);
+	static void _build_frame(WavetableTables *r_tables, int p_frame, const float *p_source, FFTProcessor *p_fft, float *r_scratch);
+	static WavetableTables *_build_tables(const PackedFloat32Array &p_frames, int p_frame_size);
+
+protected:
+	static void _bind_methods();
+
+public:
+	AudioStreamWavetable();
+	~AudioStreamWavetable();
+
+	// p_frames holds frame_count single cycles of frame_size samples back to back
+	void set_frames(const PackedFloat32Array &p_frames);
+	PackedFloat32Array get_frames() const;
+
+	// Must be a valid FFT size, see FFTProcessor.is_valid_fft_size()
+	void set_frame_size(int p_size);
+	int get_frame_size() const;
+
+	void set_frequency(float p_frequency);
+	float get_frequency() const;
+
+	void set_amplitude_db(float p_amplitude_db);
+	float get_amplitude_db() const;
+
+	// 0 = first frame, 1 = last frame
+	void set_morph(float p_morph);
+	float get_morph() const;
+
+	int get_frame_count() const;
+	int get_mip_count() const;
+	bool is_ready() const;
+
+	// Audio thread access
+	bool read_params(Params &r_params) const { return params.read(r_params); }
+
+	// The current tables (or nullptr), valid until the matching release_tables(). The count goes up
+	// before the pointer is read, so a set replaced after that is not freed under the reader.
+	const WavetableTables *acquire_tables() const {
+		table_readers.fetch_add(1, std::memory_order_seq_cst);
+		return tables.load(std::memory_order_seq_cst);
+	}
+	void release_tables() const { table_readers.fetch_sub(1, std::memory_order_release); }
+
+	virtual Ref<AudioStreamPlayback> _instantiate_playback() const override;
+	virtual String _get_stream_name() const override;
+	virtual double _get_length() const override;
+	virtual bool _is_monophonic() const override;
+	virtual double _get_bpm() const override;
+	virtual int32_t _get_beat_count() const override;
+};
+
+#endif // AUDIO_STREAM_WAVETABLE_H
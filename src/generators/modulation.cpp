@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*  modulation.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "modulation.h"
+
+// ControlLFO Implementation
+
+void ControlLFO::reset(uint32_t p_seed) {
+	phase = 0.0f;
+	held = 0.0f;
+	random_state = p_seed ? p_seed : 1;
+}
+
+float ControlLFO::tick(Shape p_shape, float p_increment) {
+	float value = 0.0f;
+	switch (p_shape) {
+		case SHAPE_SINE: {
+			// Parabola with one correction step, max error ~0.001: plenty for modulation
+			float x = 1.0f - 2.0f * phase; // sin(2 pi phase) = sin(pi x), x in (-1, 1]
+			float y = 4.0f * x * (1.0f - (x < 0.0f ? -x : x));
+			value = y + 0.225f * y * ((y < 0.0f ? -y : y) - 1.0f);
+		} break;
+		case SHAPE_TRIANGLE:
+			// Starts at 0 rising, like the sine
+			value = phase < 0.25f ? 4.0f * phase : (phase < 0.75f ? 2.0f - 4.0f * phase : 4.0f * phase - 4.0f);
+			break;
+		case SHAPE_SAW:
+			value = 2.0f * phase - 1.0f;
+			break;
+		case SHAPE_SQUARE:
+			value = phase < 0.5f ? 1.0f : -1.0f;
+			break;
+		case SHAPE_RANDOM:
+			value = held;
+			break;
+	}
+
+	phase += p_increment;
+	if (phase >= 1.0f) {
+		phase -= (float)(int)phase;
+		if (p_shape == SHAPE_RANDOM) {
+			random_state ^= random_state << 13;
+			random_state ^= random_state >> 17;
+			random_state ^= random_state << 5;
+			held = (random_state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+		}
+	}
+	return value;
+}
+
+// ModMatrix Implementation
+
+void ModMatrix::compile(const Route *p_routes, int p_count, int p_source_count, int p_destination_count, Routing &r_routing) {
+	r_routing.count = 0;
+	r_routing.source_count = 0;
+	r_routing.destination_count = p_destination_count < MAX_DESTINATIONS ? p_destination_count : MAX_DESTINATIONS;
+	if (p_count > MAX_ROUTES) {
+		p_count = MAX_ROUTES;
+	}
+
+	// One pass per destination; routes keep their edit order within a destination
+	for (int d = 0; d < r_routing.destination_count; d++) {
+		for (int i = 0; i < p_count; i++) {
+			const Route &route = p_routes[i];
+			if (route.destination != d || route.source >= p_source_count || route.amount == 0.0f) {
+				continue;
+			}
+			r_routing.routes[r_routing.count++] = route;
+
+			bool listed = false;
+			for (int s = 0; s < r_routing.source_count && !listed; s++) {
+				listed = r_routing.sources[s] == route.source;
+			}
+			if (!listed) {
+				r_routing.sources[r_routing.source_count++] = route.source;
+			}
+		}
+		r_routing.destination_end[d] = (uint8_t)r_routing.count;
+	}
+}
+
+void ModMatrix::evaluate(const Routing &p_routing, const float *p_sources, float *r_destinations) {
+	int i = 0;
+	for (int d = 0; d < p_routing.destination_count; d++) {
+		float sum = 0.0f;
+		for (; i < p_routing.destination_end[d]; i++) {
+			sum += p_sources[p_routing.routes[i].source] * p_routing.routes[i].amount;
+		}
+		r_destinations[d] = sum;
+	}
+}
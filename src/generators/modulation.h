@@ -0,0 +1,67 @@
+/**************************************************************************/
+/*  modulation.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef MODULATION_H
+#define MODULATION_H
+
+#include <cstdint>
+
+// Low-frequency oscillator for modulation. It is evaluated once per control tick (every few
+// samples), not per sample, so shapes use cheap approximations and a switch per tick is fine.
+struct ControlLFO {
+	enum Shape {
+		SHAPE_SINE,
+		SHAPE_TRIANGLE,
+		SHAPE_SAW,
+		SHAPE_SQUARE,
+		SHAPE_RANDOM, // Sample and hold, a new value every cycle
+	};
+
+	float phase = 0.0f; // Cycles, [0, 1)
+	float held = 0.0f; // SHAPE_RANDOM output
+	uint32_t random_state = 1;
+
+	void reset(uint32_t p_seed);
+
+	// Value at the current phase in [-1, 1], then advances by p_increment cycles
+	float tick(Shape p_shape, float p_increment);
+};
+
+// Routes from modulation sources to destinations. The editable list is compiled into a flat array
+// grouped by destination whenever the patch changes; evaluating it is one pass over that array
+// with no lookups. Both forms are trivially copyable, so they travel inside a ParamSnapshot.
+class ModMatrix {
+public:
+	static constexpr int MAX_ROUTES = 32;
+	static constexpr int MAX_DESTINATIONS = 16;
+
+	struct Route {
+		uint16_t source = 0;
+		uint16_t destination = 0;
+		float amount = 0.0f;
+	};
+
+	struct Routing {
+		Route routes[MAX_ROUTES]; // Grouped by destination
+		uint8_t destination_end[MAX_DESTINATIONS] = {}; // Routes to d end at destination_end[d]
+		uint16_t sources[MAX_ROUTES]; // Each source used by a route, once
+		int count = 0;
+		int destination_count = 0;
+		int source_count = 0;
+	};
+
+	// Drops routes outside the source / destination counts (and zero amounts), then groups the
+	// rest by destination. p_destination_count is at most MAX_DESTINATIONS.
+	static void compile(const Route *p_routes, int p_count, int p_source_count, int p_destination_count, Routing &r_routing);
+
+	// r_destinations[d] = sum of p_sources[source] * amount over the routes to d; 0 without routes.
+	// Sources not listed in p_routing.sources are never read.
+	static void evaluate(const Routing &p_routing, const float *p_sources, float *r_destinations);
+};
+
+#endif // MODULATION_H
@@ -0,0 +1,1082 @@
+/**************************************************************************/
+/*  osc_kernels.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#include "osc_kernels.h"
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OSC_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 voice kernels are compiled with a target attribute and chosen at runtime
+#if defined(OSC_KERNELS_SSE2) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define OSC_KERNELS_AVX2
+#define AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+static const float TWO_PI = 6.2831853072f;
+static const double TWO_PI_DOUBLE = 6.283185307179586;
+
+// PolyBLEP/BLAMP corrections assume less than half a cycle per sample
+static const float MAX_INCREMENT = 0.49f;
+
+// Taylor terms of sin(x) up to x^11, for the vector sine on [-pi/2, pi/2]
+static const float SINE_C3 = -1.0f / 6.0f;
+static const float SINE_C5 = 1.0f / 120.0f;
+static const float SINE_C7 = -1.0f / 5040.0f;
+static const float SINE_C9 = 1.0f / 362880.0f;
+static const float SINE_C11 = -1.0f / 39916800.0f;
+
+// Top 24 bits of a fixed-point phase as a float in [0, 1), exact
+static const float PHASE_BITS_TO_CYCLES = 1.0f / 16777216.0f;
+
+static inline float _phase_to_float(uint32_t p_phase) {
+	return (float)(p_phase >> 8) * PHASE_BITS_TO_CYCLES;
+}
+
+static const double PHASE_64_TO_CYCLES = 1.0 / 18446744073709551616.0;
+
+// 64-bit State phase -> the 32-bit phase the kernels step per sample
+static inline uint32_t _phase_high(uint64_t p_phase) {
+	return (uint32_t)(p_phase >> 32);
+}
+
+// Rounded, so a block strays at most half a step per sample from the exact phase
+static inline uint32_t _increment_high(uint64_t p_increment) {
+	return (uint32_t)((p_increment + 0x80000000u) >> 32);
+}
+
+// Scalar versions, used for the tails of the vector loops and in builds without SSE2
+
+static inline float _wrap_scalar(float p_phase) {
+	return p_phase >= 1.0f ? p_phase - 1.0f : p_phase;
+}
+
+// PolyBLEP residual of a step of height 2 at phase 0 (two-sample polynomial)
+static inline float _poly_blep(float p_t, float p_dt, float p_inv_dt) {
+	if (p_t < p_dt) {
+		float x = p_t * p_inv_dt;
+		return x + x - x * x - 1.0f;
+	}
+	if (p_t > 1.0f - p_dt) {
+		float x = (p_t - 1.0f) * p_inv_dt;
+		return x * x + x + x + 1.0f;
+	}
+	return 0.0f;
+}
+
+// PolyBLAMP residual of a slope change of 2 per sample at phase 0 (integral of the BLEP)
+static inline float _poly_blamp(float p_t, float p_dt, float p_inv_dt) {
+	if (p_t < p_dt) {
+		float x = p_t * p_inv_dt - 1.0f;
+		return -x * x * x * (1.0f / 3.0f);
+	}
+	if (p_t > 1.0f - p_dt) {
+		float x = (p_t - 1.0f) * p_inv_dt + 1.0f;
+		return x * x * x * (1.0f / 3.0f);
+	}
+	return 0.0f;
+}
+
+template <OscKernels::Shape S>
+static inline float _shape_scalar(float p_t, float p_dt, float p_inv_dt, float p_width) {
+	if constexpr (S == OscKernels::SHAPE_SINE) {
+		return sinf(TWO_PI * p_t);
+	} else if constexpr (S == OscKernels::SHAPE_SAW || S == OscKernels::SHAPE_SAW_BLEP) {
+		float value = 2.0f * p_t - 1.0f;
+		if constexpr (S == OscKernels::SHAPE_SAW_BLEP) {
+			value -= _poly_blep(p_t, p_dt, p_inv_dt);
+		}
+		return value;
+	} else if constexpr (S == OscKernels::SHAPE_TRIANGLE || S == OscKernels::SHAPE_TRIANGLE_BLAMP) {
+		// Starts at 0 rising like the sine; trough at u = 0, peak at u = 0.5
+		float u = _wrap_scalar(p_t + 0.25f);
+		float value = 1.0f - 4.0f * fabsf(u - 0.5f);
+		if constexpr (S == OscKernels::SHAPE_TRIANGLE_BLAMP) {
+			// Slope changes by 8 per cycle = 8 * dt per sample, the residual is for 2 per sample
+			float scale = 4.0f * p_dt;
+			value += scale * (_poly_blamp(u, p_dt, p_inv_dt) - _poly_blamp(_wrap_scalar(u + 0.5f), p_dt, p_inv_dt));
+		}
+		return value;
+	} else {
+		// Square and pulse: +1 up to the width, -1 after; the pulse is DC-free
+		float value = p_t < p_width ? 1.0f : -1.0f;
+		if constexpr (S == OscKernels::SHAPE_SQUARE_BLEP || S == OscKernels::SHAPE_PULSE_BLEP) {
+			value += _poly_blep(p_t, p_dt, p_inv_dt) - _poly_blep(_wrap_scalar(p_t + 1.0f - p_width), p_dt, p_inv_dt);
+		}
+		if constexpr (S == OscKernels::SHAPE_PULSE || S == OscKernels::SHAPE_PULSE_BLEP) {
+			value -= 2.0f * p_width - 1.0f;
+		}
+		return value;
+	}
+}
+
+#ifdef OSC_KERNELS_SSE2
+static inline __m128 _phase_to_float_sse2(__m128i p_phase) {
+	return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(p_phase, 8)), _mm_set1_ps(PHASE_BITS_TO_CYCLES));
+}
+
+static inline __m128 _wrap_sse2(__m128 p_phase) {
+	__m128 over = _mm_cmpge_ps(p_phase, _mm_set1_ps(1.0f));
+	return _mm_sub_ps(p_phase, _mm_and_ps(over, _mm_set1_ps(1.0f)));
+}
+
+static inline __m128 _poly_blep_sse2(__m128 p_t, __m128 p_dt, __m128 p_inv_dt) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 after_mask = _mm_cmplt_ps(p_t, p_dt);
+	__m128 before_mask = _mm_cmpgt_ps(p_t, _mm_sub_ps(one, p_dt));
+	__m128 near = _mm_or_ps(after_mask, before_mask);
+	if (_mm_movemask_ps(near) == 0) {
+		return _mm_setzero_ps(); // Most blocks of 4 are nowhere near an edge
+	}
+	__m128 after = _mm_mul_ps(p_t, p_inv_dt);
+	__m128 before = _mm_mul_ps(_mm_sub_ps(p_t, one), p_inv_dt);
+	__m128 after_value = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(after, after), _mm_mul_ps(after, after)), one);
+	__m128 before_value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(before, before), _mm_add_ps(before, before)), one);
+	return _mm_or_ps(_mm_and_ps(after_mask, after_value), _mm_and_ps(before_mask, before_value));
+}
+
+static inline __m128 _poly_blamp_sse2(__m128 p_t, __m128 p_dt, __m128 p_inv_dt) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 third = _mm_set1_ps(1.0f / 3.0f);
+	__m128 after_mask = _mm_cmplt_ps(p_t, p_dt);
+	__m128 before_mask = _mm_cmpgt_ps(p_t, _mm_sub_ps(one, p_dt));
+	__m128 near = _mm_or_ps(after_mask, before_mask);
+	if (_mm_movemask_ps(near) == 0) {
+		return _mm_setzero_ps(); // Most blocks of 4 are nowhere near an edge
+	}
+	__m128 after = _mm_sub_ps(_mm_mul_ps(p_t, p_inv_dt), one);
+	__m128 before = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(p_t, one), p_inv_dt), one);
+	__m128 after_value = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(after, after), after), _mm_sub_ps(_mm_setzero_ps(), third));
+	__m128 before_value = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(before, before), before), third);
+	return _mm_or_ps(_mm_and_ps(after_mask, after_value), _mm_and_ps(before_mask, before_value));
+}
+
+// sin(2 pi t) for t in [0, 1): folded into a quarter cycle, then an odd polynomial (max error ~1e-7)
+static inline __m128 _sine_sse2(__m128 p_t) {
+	const __m128 sign_mask = _mm_set1_ps(-0.0f);
+	__m128 x = _mm_sub_ps(p_t, _mm_set1_ps(0.5f)); // sin(2 pi t) = -sin(2 pi x)
+	__m128 sign = _mm_and_ps(x, sign_mask);
+	__m128 a = _mm_andnot_ps(sign_mask, x);
+	a = _mm_min_ps(a, _mm_sub_ps(_mm_set1_ps(0.5f), a));
+	__m128 theta = _mm_mul_ps(a, _mm_set1_ps(TWO_PI));
+	__m128 z = _mm_mul_ps(theta, theta);
+	__m128 poly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SINE_C11), z), _mm_set1_ps(SINE_C9));
+	poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(SINE_C7));
+	poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(SINE_C5));
+	poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(SINE_C3));
+	poly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(poly, z), theta), theta);
+	return _mm_xor_ps(poly, _mm_xor_ps(sign, sign_mask));
+}
+
+template <OscKernels::Shape S>
+static inline __m128 _shape_sse2(__m128 p_t, __m128 p_dt, __m128 p_inv_dt, __m128 p_width) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	if constexpr (S == OscKernels::SHAPE_SINE) {
+		return _sine_sse2(p_t);
+	} else if constexpr (S == OscKernels::SHAPE_SAW || S == OscKernels::SHAPE_SAW_BLEP) {
+		__m128 value = _mm_sub_ps(_mm_add_ps(p_t, p_t), one);
+		if constexpr (S == OscKernels::SHAPE_SAW_BLEP) {
+			value = _mm_sub_ps(value, _poly_blep_sse2(p_t, p_dt, p_inv_dt));
+		}
+		return value;
+	} else if constexpr (S == OscKernels::SHAPE_TRIANGLE || S == OscKernels::SHAPE_TRIANGLE_BLAMP) {
+		const __m128 half = _mm_set1_ps(0.5f);
+		__m128 u = _wrap_sse2(_mm_add_ps(p_t, _mm_set1_ps(0.25f)));
+		__m128 distance = _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_sub_ps(u, half));
+		__m128 value = _mm_sub_ps(one, _mm_mul_ps(_mm_set1_ps(4.0f), distance));
+		if constexpr (S == OscKernels::SHAPE_TRIANGLE_BLAMP) {
+			__m128 scale = _mm_mul_ps(_mm_set1_ps(4.0f), p_dt);
+			__m128 corners = _mm_sub_ps(_poly_blamp_sse2(u, p_dt, p_inv_dt), _poly_blamp_sse2(_wrap_sse2(_mm_add_ps(u, half)), p_dt, p_inv_dt));
+			value = _mm_add_ps(value, _mm_mul_ps(scale, corners));
+		}
+		return value;
+	} else {
+		// +1 below the width, -1 above: flip the sign bit where phase >= width
+		__m128 upper = _mm_cmpge_ps(p_t, p_width);
+		__m128 value = _mm_xor_ps(one, _mm_and_ps(upper, _mm_set1_ps(-0.0f)));
+		if constexpr (S == OscKernels::SHAPE_SQUARE_BLEP || S == OscKernels::SHAPE_PULSE_BLEP) {
+			__m128 falling = _wrap_sse2(_mm_sub_ps(_mm_add_ps(p_t, one), p_width));
+			value = _mm_add_ps(value, _mm_sub_ps(_poly_blep_sse2(p_t, p_dt, p_inv_dt), _poly_blep_sse2(falling, p_dt, p_inv_dt)));
+		}
+		if constexpr (S == OscKernels::SHAPE_PULSE || S == OscKernels::SHAPE_PULSE_BLEP) {
+			value = _mm_sub_ps(value, _mm_sub_ps(_mm_add_ps(p_width, p_width), one));
+		}
+		return value;
+	}
+}
+#endif
+
+#ifdef OSC_KERNELS_SSE2
+// Spans shorter than this (modulated frequency, see AudioStreamOsc) use the polynomial sine,
+// the phasor setup would cost more than it saves
+static const int PHASOR_MIN_COUNT = 64;
+// Steps of the phasor between magnitude corrections
+static const int PHASOR_RENORMALIZE_STEPS = 16;
+
+// Recursive quadrature sine: eight phasors e^(i 2 pi (phase + k * increment)), each rotated by
+// e^(i 2 pi 8 * increment) per step, so eight samples cost one complex multiply per lane instead of
+// a polynomial. The lanes are seeded in double from the phase at every call, so the rotation's
+// rounding never builds up past one call; within a call the magnitude is pulled back to 1 with one
+// Newton step every PHASOR_RENORMALIZE_STEPS steps. Returns the samples rendered (a multiple of 8).
+static int _render_sine_phasor(float *p_output, int p_count, double p_phase, double p_increment, float p_amplitude, float p_amplitude_step) {
+	double step_re = cos(TWO_PI_DOUBLE * p_increment);
+	double step_im = sin(TWO_PI_DOUBLE * p_increment);
+	double re = cos(TWO_PI_DOUBLE * p_phase);
+	double im = sin(TWO_PI_DOUBLE * p_phase);
+
+	alignas(16) float lane_re[8];
+	alignas(16) float lane_im[8];
+	for (int k = 0; k < 8; k++) {
+		lane_re[k] = (float)re;
+		lane_im[k] = (float)im;
+		double next_re = re * step_re - im * step_im;
+		im = re * step_im + im * step_re;
+		re = next_re;
+	}
+	// step^8, by squaring
+	for (int k = 0; k < 3; k++) {
+		double next_re = step_re * step_re - step_im * step_im;
+		step_im = 2.0 * step_re * step_im;
+		step_re = next_re;
+	}
+
+	const __m128 rotation_re = _mm_set1_ps((float)step_re);
+	const __m128 rotation_im = _mm_set1_ps((float)step_im);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 three_halves = _mm_set1_ps(1.5f);
+	const __m128 amplitude_step8 = _mm_set1_ps(8.0f * p_amplitude_step);
+	__m128 re_lo = _mm_load_ps(lane_re);
+	__m128 im_lo = _mm_load_ps(lane_im);
+	__m128 re_hi = _mm_load_ps(lane_re + 4);
+	__m128 im_hi = _mm_load_ps(lane_im + 4);
+	__m128 amplitude_lo = _mm_add_ps(_mm_set1_ps(p_amplitude), _mm_mul_ps(_mm_set1_ps(p_amplitude_step), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)));
+	__m128 amplitude_hi = _mm_add_ps(_mm_set1_ps(p_amplitude), _mm_mul_ps(_mm_set1_ps(p_amplitude_step), _mm_set_ps(7.0f, 6.0f, 5.0f, 4.0f)));
+
+	int i = 0;
+	int steps = 0;
+	for (; i + 8 <= p_count; i += 8) {
+		_mm_storeu_ps(p_output + i, _mm_mul_ps(im_lo, amplitude_lo));
+		_mm_storeu_ps(p_output + i + 4, _mm_mul_ps(im_hi, amplitude_hi));
+		amplitude_lo = _mm_add_ps(amplitude_lo, amplitude_step8);
+		amplitude_hi = _mm_add_ps(amplitude_hi, amplitude_step8);
+
+		__m128 next_lo = _mm_sub_ps(_mm_mul_ps(re_lo, rotation_re), _mm_mul_ps(im_lo, rotation_im));
+		__m128 next_hi = _mm_sub_ps(_mm_mul_ps(re_hi, rotation_re), _mm_mul_ps(im_hi, rotation_im));
+		im_lo = _mm_add_ps(_mm_mul_ps(re_lo, rotation_im), _mm_mul_ps(im_lo, rotation_re));
+		im_hi = _mm_add_ps(_mm_mul_ps(re_hi, rotation_im), _mm_mul_ps(im_hi, rotation_re));
+		re_lo = next_lo;
+		re_hi = next_hi;
+
+		if (++steps == PHASOR_RENORMALIZE_STEPS) {
+			// 1 / |z| ~= 1.5 - 0.5 |z|^2 while |z| stays near 1
+			steps = 0;
+			__m128 gain_lo = _mm_sub_ps(three_halves, _mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(re_lo, re_lo), _mm_mul_ps(im_lo, im_lo))));
+			__m128 gain_hi = _mm_sub_ps(three_halves, _mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(re_hi, re_hi), _mm_mul_ps(im_hi, im_hi))));
+			re_lo = _mm_mul_ps(re_lo, gain_lo);
+			im_lo = _mm_mul_ps(im_lo, gain_lo);
+			re_hi = _mm_mul_ps(re_hi, gain_hi);
+			im_hi = _mm_mul_ps(im_hi, gain_hi);
+		}
+	}
+	return i;
+}
+#endif
+
+template <OscKernels::Shape S>
+static void _render(float *p_output, int p_count, OscKernels::State &r_state) {
+	constexpr bool SQUARE = S == OscKernels::SHAPE_SQUARE || S == OscKernels::SHAPE_SQUARE_BLEP;
+
+	uint32_t phase = _phase_high(r_state.phase);
+	const uint32_t increment = _increment_high(r_state.increment);
+	float amplitude = r_state.amplitude;
+	const float amplitude_step = r_state.amplitude_step;
+	const float width = SQUARE ? 0.5f : r_state.pulse_width;
+	const float dt = fminf(_phase_to_float(increment), MAX_INCREMENT);
+	const float inv_dt = dt > 0.0f ? 1.0f / dt : 0.0f;
+
+	int i = 0;
+
+#ifdef OSC_KERNELS_SSE2
+	if constexpr (S == OscKernels::SHAPE_SINE) {
+		if (p_count >= PHASOR_MIN_COUNT) {
+			i = _render_sine_phasor(p_output, p_count, r_state.phase * PHASE_64_TO_CYCLES, r_state.increment * PHASE_64_TO_CYCLES, amplitude, amplitude_step);
+			phase += (uint32_t)i * increment;
+			amplitude += i * amplitude_step;
+		}
+	}
+
+	{
+		// Four integer phases one sample apart; the adds wrap by themselves
+		const int first = i;
+		__m128i phase4 = _mm_add_epi32(_mm_set1_epi32((int32_t)phase), _mm_set_epi32((int32_t)(3 * increment), (int32_t)(2 * increment), (int32_t)increment, 0));
+		const __m128i step = _mm_set1_epi32((int32_t)(4 * increment));
+		const __m128 dt4 = _mm_set1_ps(dt);
+		const __m128 inv_dt4 = _mm_set1_ps(inv_dt);
+		const __m128 width4 = _mm_set1_ps(width);
+		const __m128 amplitude_step4 = _mm_set1_ps(4.0f * amplitude_step);
+		__m128 amplitude4 = _mm_add_ps(_mm_set1_ps(amplitude), _mm_set_ps(3.0f * amplitude_step, 2.0f * amplitude_step, amplitude_step, 0.0f));
+
+		for (; i + 4 <= p_count; i += 4) {
+			__m128 t = _phase_to_float_sse2(phase4);
+			_mm_storeu_ps(p_output + i, _mm_mul_ps(_shape_sse2<S>(t, dt4, inv_dt4, width4), amplitude4));
+			amplitude4 = _mm_add_ps(amplitude4, amplitude_step4);
+			phase4 = _mm_add_epi32(phase4, step);
+		}
+		phase += (uint32_t)(i - first) * increment;
+		amplitude += (i - first) * amplitude_step;
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		p_output[i] = amplitude * _shape_scalar<S>(_phase_to_float(phase), dt, inv_dt, width);
+		amplitude += amplitude_step;
+		phase += increment;
+	}
+
+	r_state.phase += (uint64_t)p_count * r_state.increment;
+	r_state.amplitude = amplitude;
+}
+
+void OscKernels::render(Shape p_shape, float *p_output, int p_count, State &r_state) {
+	switch (p_shape) {
+		case SHAPE_SINE:
+			_render<SHAPE_SINE>(p_output, p_count, r_state);
+			break;
+		case SHAPE_SAW:
+			_render<SHAPE_SAW>(p_output, p_count, r_state);
+			break;
+		case SHAPE_SQUARE:
+			_render<SHAPE_SQUARE>(p_output, p_count, r_state);
+			break;
+		case SHAPE_TRIANGLE:
+			_render<SHAPE_TRIANGLE>(p_output, p_count, r_state);
+			break;
+		case SHAPE_PULSE:
+			_render<SHAPE_PULSE>(p_output, p_count, r_state);
+			break;
+		case SHAPE_SAW_BLEP:
+			_render<SHAPE_SAW_BLEP>(p_output, p_count, r_state);
+			break;
+		case SHAPE_SQUARE_BLEP:
+			_render<SHAPE_SQUARE_BLEP>(p_output, p_count, r_state);
+			break;
+		case SHAPE_TRIANGLE_BLAMP:
+			_render<SHAPE_TRIANGLE_BLAMP>(p_output, p_count, r_state);
+			break;
+		case SHAPE_PULSE_BLEP:
+			_render<SHAPE_PULSE_BLEP>(p_output, p_count, r_state);
+			break;
+	}
+}
+
+// Voice groups: one voice per lane, several samples per iteration, lanes summed at the end
+
+static OscKernels::SimdLevel _detect_simd_level() {
+#ifdef OSC_KERNELS_AVX2
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return OscKernels::SIMD_AVX2;
+	}
+#endif
+#ifdef OSC_KERNELS_SSE2
+	return OscKernels::SIMD_SSE2;
+#else
+	return OscKernels::SIMD_SCALAR;
+#endif
+}
+
+static const OscKernels::SimdLevel supported_simd_level = _detect_simd_level();
+// Bound to scripts (AudioStreamSynth.set_simd_level()), so it may change while the audio thread renders
+static std::atomic<OscKernels::SimdLevel> simd_level{ supported_simd_level };
+
+template <OscKernels::Shape S, bool STEREO>
+static void _render_voices_scalar(OscKernels::VoiceGroup &r_group, int p_lanes, float p_width, float *p_output, float *p_right, int p_count) {
+	for (int lane = 0; lane < p_lanes; lane++) {
+		uint32_t phase = r_group.phase[lane];
+		float gain = r_group.gain[lane];
+		const uint32_t increment = r_group.increment[lane];
+		const float mul = r_group.gain_mul[lane];
+		const float step = r_group.gain_step[lane];
+		const float gain_min = r_group.gain_min[lane];
+		const float gain_max = r_group.gain_max[lane];
+		const float pan_left = r_group.pan_left[lane];
+		const float pan_right = r_group.pan_right[lane];
+		const float dt = fminf(_phase_to_float(increment), MAX_INCREMENT);
+		const float inv_dt = dt > 0.0f ? 1.0f / dt : 0.0f;
+
+		for (int i = 0; i < p_count; i++) {
+			float value = gain * _shape_scalar<S>(_phase_to_float(phase), dt, inv_dt, p_width);
+			if constexpr (STEREO) {
+				p_output[i] += value * pan_left;
+				p_right[i] += value * pan_right;
+			} else {
+				p_output[i] += value;
+			}
+			phase += increment;
+			gain = gain * mul + step;
+			gain = gain < gain_min ? gain_min : (gain > gain_max ? gain_max : gain);
+		}
+
+		r_group.phase[lane] = phase;
+		r_group.gain[lane] = gain;
+	}
+}
+
+#ifdef OSC_KERNELS_SSE2
+// Row k holds sample k of every lane; a transpose turns lanes into samples, summed into p_output[0..3]
+static inline void _add_lane_sums_sse2(__m128 *p_rows, float *p_output) {
+	_MM_TRANSPOSE4_PS(p_rows[0], p_rows[1], p_rows[2], p_rows[3]);
+	__m128 sum = _mm_add_ps(_mm_add_ps(p_rows[0], p_rows[1]), _mm_add_ps(p_rows[2], p_rows[3]));
+	_mm_storeu_ps(p_output, _mm_add_ps(_mm_loadu_ps(p_output), sum));
+}
+
+static inline float _lane_sum_sse2(__m128 p_value) {
+	alignas(16) float lanes[4];
+	_mm_store_ps(lanes, p_value);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// Four lanes starting at p_first
+template <OscKernels::Shape S, bool STEREO>
+static void _render_voices_sse2(OscKernels::VoiceGroup &r_group, int p_first, float p_width, float *p_output, float *p_right, int p_count) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 width = _mm_set1_ps(p_width);
+	const __m128i increment = _mm_load_si128((const __m128i *)(r_group.increment + p_first));
+	const __m128 mul = _mm_load_ps(r_group.gain_mul + p_first);
+	const __m128 step = _mm_load_ps(r_group.gain_step + p_first);
+	const __m128 gain_min = _mm_load_ps(r_group.gain_min + p_first);
+	const __m128 gain_max = _mm_load_ps(r_group.gain_max + p_first);
+	const __m128 pan_left = _mm_load_ps(r_group.pan_left + p_first);
+	const __m128 pan_right = _mm_load_ps(r_group.pan_right + p_first);
+	const __m128 dt = _mm_min_ps(_phase_to_float_sse2(increment), _mm_set1_ps(MAX_INCREMENT));
+	const __m128 inv_dt = _mm_and_ps(_mm_cmpgt_ps(dt, _mm_setzero_ps()), _mm_div_ps(one, dt));
+	__m128i phase = _mm_load_si128((const __m128i *)(r_group.phase + p_first));
+	__m128 gain = _mm_load_ps(r_group.gain + p_first);
+
+	int i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 rows[4];
+		for (int k = 0; k < 4; k++) {
+			rows[k] = _mm_mul_ps(_shape_sse2<S>(_phase_to_float_sse2(phase), dt, inv_dt, width), gain);
+			phase = _mm_add_epi32(phase, increment);
+			gain = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(gain, mul), step), gain_min), gain_max);
+		}
+		if constexpr (STEREO) {
+			__m128 right_rows[4];
+			for (int k = 0; k < 4; k++) {
+				right_rows[k] = _mm_mul_ps(rows[k], pan_right);
+				rows[k] = _mm_mul_ps(rows[k], pan_left);
+			}
+			_add_lane_sums_sse2(right_rows, p_right + i);
+		}
+		_add_lane_sums_sse2(rows, p_output + i);
+	}
+
+	for (; i < p_count; i++) {
+		__m128 value = _mm_mul_ps(_shape_sse2<S>(_phase_to_float_sse2(phase), dt, inv_dt, width), gain);
+		if constexpr (STEREO) {
+			p_output[i] += _lane_sum_sse2(_mm_mul_ps(value, pan_left));
+			p_right[i] += _lane_sum_sse2(_mm_mul_ps(value, pan_right));
+		} else {
+			p_output[i] += _lane_sum_sse2(value);
+		}
+		phase = _mm_add_epi32(phase, increment);
+		gain = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(gain, mul), step), gain_min), gain_max);
+	}
+
+	_mm_store_si128((__m128i *)(r_group.phase + p_first), phase);
+	_mm_store_ps(r_group.gain + p_first, gain);
+}
+#endif // OSC_KERNELS_SSE2
+
+#ifdef OSC_KERNELS_AVX2
+// Same waveforms as the SSE2 versions, eight lanes wide
+
+AVX2_TARGET static inline __m256 _phase_to_float_avx2(__m256i p_phase) {
+	return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(p_phase, 8)), _mm256_set1_ps(PHASE_BITS_TO_CYCLES));
+}
+
+AVX2_TARGET static inline __m256 _wrap_avx2(__m256 p_phase) {
+	__m256 over = _mm256_cmp_ps(p_phase, _mm256_set1_ps(1.0f), _CMP_GE_OQ);
+	return _mm256_sub_ps(p_phase, _mm256_and_ps(over, _mm256_set1_ps(1.0f)));
+}
+
+AVX2_TARGET static inline __m256 _sine_avx2(__m256 p_t) {
+	const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+	__m256 x = _mm256_sub_ps(p_t, _mm256_set1_ps(0.5f));
+	__m256 sign = _mm256_and_ps(x, sign_mask);
+	__m256 a = _mm256_andnot_ps(sign_mask, x);
+	a = _mm256_min_ps(a, _mm256_sub_ps(_mm256_set1_ps(0.5f), a));
+	__m256 theta = _mm256_mul_ps(a, _mm256_set1_ps(TWO_PI));
+	__m256 z = _mm256_mul_ps(theta, theta);
+	__m256 poly = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(SINE_C11), z), _mm256_set1_ps(SINE_C9));
+	poly = _mm256_add_ps(_mm256_mul_ps(poly, z), _mm256_set1_ps(SINE_C7));
+	poly = _mm256_add_ps(_mm256_mul_ps(poly, z), _mm256_set1_ps(SINE_C5));
+	poly = _mm256_add_ps(_mm256_mul_ps(poly, z), _mm256_set1_ps(SINE_C3));
+	poly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(poly, z), theta), theta);
+	return _mm256_xor_ps(poly, _mm256_xor_ps(sign, sign_mask));
+}
+
+AVX2_TARGET static inline __m256 _poly_blep_avx2(__m256 p_t, __m256 p_dt, __m256 p_inv_dt) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	__m256 after_mask = _mm256_cmp_ps(p_t, p_dt, _CMP_LT_OQ);
+	__m256 before_mask = _mm256_cmp_ps(p_t, _mm256_sub_ps(one, p_dt), _CMP_GT_OQ);
+	if (_mm256_movemask_ps(_mm256_or_ps(after_mask, before_mask)) == 0) {
+		return _mm256_setzero_ps();
+	}
+	__m256 after = _mm256_mul_ps(p_t, p_inv_dt);
+	__m256 before = _mm256_mul_ps(_mm256_sub_ps(p_t, one), p_inv_dt);
+	__m256 after_value = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(after, after), _mm256_mul_ps(after, after)), one);
+	__m256 before_value = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(before, before), _mm256_add_ps(before, before)), one);
+	return _mm256_or_ps(_mm256_and_ps(after_mask, after_value), _mm256_and_ps(before_mask, before_value));
+}
+
+AVX2_TARGET static inline __m256 _poly_blamp_avx2(__m256 p_t, __m256 p_dt, __m256 p_inv_dt) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 third = _mm256_set1_ps(1.0f / 3.0f);
+	__m256 after_mask = _mm256_cmp_ps(p_t, p_dt, _CMP_LT_OQ);
+	__m256 before_mask = _mm256_cmp_ps(p_t, _mm256_sub_ps(one, p_dt), _CMP_GT_OQ);
+	if (_mm256_movemask_ps(_mm256_or_ps(after_mask, before_mask)) == 0) {
+		return _mm256_setzero_ps();
+	}
+	__m256 after = _mm256_sub_ps(_mm256_mul_ps(p_t, p_inv_dt), one);
+	__m256 before = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(p_t, one), p_inv_dt), one);
+	__m256 after_value = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(after, after), after), _mm256_sub_ps(_mm256_setzero_ps(), third));
+	__m256 before_value = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(before, before), before), third);
+	return _mm256_or_ps(_mm256_and_ps(after_mask, after_value), _mm256_and_ps(before_mask, before_value));
+}
+
+template <OscKernels::Shape S>
+AVX2_TARGET static inline __m256 _shape_avx2(__m256 p_t, __m256 p_dt, __m256 p_inv_dt, __m256 p_width) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	if constexpr (S == OscKernels::SHAPE_SINE) {
+		return _sine_avx2(p_t);
+	} else if constexpr (S == OscKernels::SHAPE_SAW || S == OscKernels::SHAPE_SAW_BLEP) {
+		__m256 value = _mm256_sub_ps(_mm256_add_ps(p_t, p_t), one);
+		if constexpr (S == OscKernels::SHAPE_SAW_BLEP) {
+			value = _mm256_sub_ps(value, _poly_blep_avx2(p_t, p_dt, p_inv_dt));
+		}
+		return value;
+	} else if constexpr (S == OscKernels::SHAPE_TRIANGLE || S == OscKernels::SHAPE_TRIANGLE_BLAMP) {
+		const __m256 half = _mm256_set1_ps(0.5f);
+		__m256 u = _wrap_avx2(_mm256_add_ps(p_t, _mm256_set1_ps(0.25f)));
+		__m256 distance = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), _mm256_sub_ps(u, half));
+		__m256 value = _mm256_sub_ps(one, _mm256_mul_ps(_mm256_set1_ps(4.0f), distance));
+		if constexpr (S == OscKernels::SHAPE_TRIANGLE_BLAMP) {
+			__m256 scale = _mm256_mul_ps(_mm256_set1_ps(4.0f), p_dt);
+			__m256 corners = _mm256_sub_ps(_poly_blamp_avx2(u, p_dt, p_inv_dt), _poly_blamp_avx2(_wrap_avx2(_mm256_add_ps(u, half)), p_dt, p_inv_dt));
+			value = _mm256_add_ps(value, _mm256_mul_ps(scale, corners));
+		}
+		return value;
+	} else {
+		__m256 upper = _mm256_cmp_ps(p_t, p_width, _CMP_GE_OQ);
+		__m256 value = _mm256_xor_ps(one, _mm256_and_ps(upper, _mm256_set1_ps(-0.0f)));
+		if constexpr (S == OscKernels::SHAPE_SQUARE_BLEP || S == OscKernels::SHAPE_PULSE_BLEP) {
+			__m256 falling = _wrap_avx2(_mm256_sub_ps(_mm256_add_ps(p_t, one), p_width));
+			value = _mm256_add_ps(value, _mm256_sub_ps(_poly_blep_avx2(p_t, p_dt, p_inv_dt), _poly_blep_avx2(falling, p_dt, p_inv_dt)));
+		}
+		if constexpr (S == OscKernels::SHAPE_PULSE || S == OscKernels::SHAPE_PULSE_BLEP) {
+			value = _mm256_sub_ps(value, _mm256_sub_ps(_mm256_add_ps(p_width, p_width), one));
+		}
+		return value;
+	}
+}
+
+// Horizontal sums of 8 rows: hadd within 128-bit halves, then add the halves; summed into p_output[0..7]
+AVX2_TARGET static inline void _add_lane_sums_avx2(__m256 *p_rows, float *p_output) {
+	__m256 h01 = _mm256_hadd_ps(p_rows[0], p_rows[1]);
+	__m256 h23 = _mm256_hadd_ps(p_rows[2], p_rows[3]);
+	__m256 h45 = _mm256_hadd_ps(p_rows[4], p_rows[5]);
+	__m256 h67 = _mm256_hadd_ps(p_rows[6], p_rows[7]);
+	__m256 low = _mm256_hadd_ps(h01, h23); // Samples 0-3, lanes 0-3 | lanes 4-7
+	__m256 high = _mm256_hadd_ps(h45, h67); // Samples 4-7
+	__m256 sum = _mm256_add_ps(_mm256_permute2f128_ps(low, high, 0x20), _mm256_permute2f128_ps(low, high, 0x31));
+	_mm256_storeu_ps(p_output, _mm256_add_ps(_mm256_loadu_ps(p_output), sum));
+}
+
+AVX2_TARGET static inline float _lane_sum_avx2(__m256 p_value) {
+	alignas(32) float lanes[8];
+	_mm256_store_ps(lanes, p_value);
+	return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+template <OscKernels::Shape S, bool STEREO>
+AVX2_TARGET static void _render_voices_avx2(OscKernels::VoiceGroup &r_group, float p_width, float *p_output, float *p_right, int p_count) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 width = _mm256_set1_ps(p_width);
+	const __m256i increment = _mm256_load_si256((const __m256i *)r_group.increment);
+	const __m256 mul = _mm256_load_ps(r_group.gain_mul);
+	const __m256 step = _mm256_load_ps(r_group.gain_step);
+	const __m256 gain_min = _mm256_load_ps(r_group.gain_min);
+	const __m256 gain_max = _mm256_load_ps(r_group.gain_max);
+	const __m256 pan_left = _mm256_load_ps(r_group.pan_left);
+	const __m256 pan_right = _mm256_load_ps(r_group.pan_right);
+	const __m256 dt = _mm256_min_ps(_phase_to_float_avx2(increment), _mm256_set1_ps(MAX_INCREMENT));
+	const __m256 inv_dt = _mm256_and_ps(_mm256_cmp_ps(dt, _mm256_setzero_ps(), _CMP_GT_OQ), _mm256_div_ps(one, dt));
+	__m256i phase = _mm256_load_si256((const __m256i *)r_group.phase);
+	__m256 gain = _mm256_load_ps(r_group.gain);
+
+	int i = 0;
+	for (; i + 8 <= p_count; i += 8) {
+		__m256 rows[8];
+		for (int k = 0; k < 8; k++) {
+			rows[k] = _mm256_mul_ps(_shape_avx2<S>(_phase_to_float_avx2(phase), dt, inv_dt, width), gain);
+			phase = _mm256_add_epi32(phase, increment);
+			gain = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(gain, mul), step), gain_min), gain_max);
+		}
+		if constexpr (STEREO) {
+			__m256 right_rows[8];
+			for (int k = 0; k < 8; k++) {
+				right_rows[k] = _mm256_mul_ps(rows[k], pan_right);
+				rows[k] = _mm256_mul_ps(rows[k], pan_left);
+			}
+			_add_lane_sums_avx2(right_rows, p_right + i);
+		}
+		_add_lane_sums_avx2(rows, p_output + i);
+	}
+
+	for (; i < p_count; i++) {
+		__m256 value = _mm256_mul_ps(_shape_avx2<S>(_phase_to_float_avx2(phase), dt, inv_dt, width), gain);
+		if constexpr (STEREO) {
+			p_output[i] += _lane_sum_avx2(_mm256_mul_ps(value, pan_left));
+			p_right[i] += _lane_sum_avx2(_mm256_mul_ps(value, pan_right));
+		} else {
+			p_output[i] += _lane_sum_avx2(value);
+		}
+		phase = _mm256_add_epi32(phase, increment);
+		gain = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(gain, mul), step), gain_min), gain_max);
+	}
+
+	_mm256_store_si256((__m256i *)r_group.phase, phase);
+	_mm256_store_ps(r_group.gain, gain);
+}
+#endif // OSC_KERNELS_AVX2
+
+template <OscKernels::Shape S, bool STEREO>
+static void _render_voices(OscKernels::VoiceGroup &r_group, int p_lanes, float p_pulse_width, float *p_output, float *p_right, int p_count) {
+	constexpr bool SQUARE = S == OscKernels::SHAPE_SQUARE || S == OscKernels::SHAPE_SQUARE_BLEP;
+	const float width = SQUARE ? 0.5f : p_pulse_width;
+	const OscKernels::SimdLevel level = simd_level.load(std::memory_order_relaxed);
+
+#ifdef OSC_KERNELS_AVX2
+	if (level == OscKernels::SIMD_AVX2 && p_lanes > 4) {
+		_render_voices_avx2<S, STEREO>(r_group, width, p_output, p_right, p_count);
+		return;
+	}
+#endif
+#ifdef OSC_KERNELS_SSE2
+	if (level >= OscKernels::SIMD_SSE2) {
+		_render_voices_sse2<S, STEREO>(r_group, 0, width, p_output, p_right, p_count);
+		if (p_lanes > 4) {
+			_render_voices_sse2<S, STEREO>(r_group, 4, width, p_output, p_right, p_count);
+		}
+		return;
+	}
+#endif
+	_render_voices_scalar<S, STEREO>(r_group, p_lanes, width, p_output, p_right, p_count);
+}
+
+template <bool STEREO>
+static void _render_voices_shape(OscKernels::Shape p_shape, OscKernels::VoiceGroup &r_group, int p_lanes, float p_pulse_width, float *p_output, float *p_right, int p_count) {
+	switch (p_shape) {
+		case OscKernels::SHAPE_SINE:
+			_render_voices<OscKernels::SHAPE_SINE, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+		case OscKernels::SHAPE_SAW:
+			_render_voices<OscKernels::SHAPE_SAW, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+		case OscKernels::SHAPE_SQUARE:
+			_render_voices<OscKernels::SHAPE_SQUARE, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+		case OscKernels::SHAPE_TRIANGLE:
+			_render_voices<OscKernels::SHAPE_TRIANGLE, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+		case OscKernels::SHAPE_PULSE:
+			_render_voices<OscKernels::SHAPE_PULSE, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+		case OscKernels::SHAPE_SAW_BLEP:
+			_render_voices<OscKernels::SHAPE_SAW_BLEP, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+		case OscKernels::SHAPE_SQUARE_BLEP:
+			_render_voices<OscKernels::SHAPE_SQUARE_BLEP, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+		case OscKernels::SHAPE_TRIANGLE_BLAMP:
+			_render_voices<OscKernels::SHAPE_TRIANGLE_BLAMP, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+		case OscKernels::SHAPE_PULSE_BLEP:
+			_render_voices<OscKernels::SHAPE_PULSE_BLEP, STEREO>(r_group, p_lanes, p_pulse_width, p_output, p_right, p_count);
+			break;
+	}
+}
+
+uint32_t OscKernels::phase_increment(double p_cycles) {
+	// Whole cycles wrap away; the rounding carry at the top wraps to 0 as well
+	double fraction = p_cycles - floor(p_cycles);
+	return (uint32_t)(uint64_t)(fraction * PHASE_CYCLE + 0.5);
+}
+
+uint64_t OscKernels::phase_increment_64(double p_cycles) {
+	// fraction < 1, so the product stays below 2^64
+	double fraction = p_cycles - floor(p_cycles);
+	return (uint64_t)(fraction * (PHASE_CYCLE * PHASE_CYCLE));
+}
+
+OscKernels::SimdLevel OscKernels::get_simd_level() {
+	return simd_level.load(std::memory_order_relaxed);
+}
+
+void OscKernels::set_simd_level(SimdLevel p_level) {
+	simd_level.store(p_level < supported_simd_level ? p_level : supported_simd_level, std::memory_order_relaxed);
+}
+
+void OscKernels::render_voices(Shape p_shape, VoiceGroup &r_group, int p_lanes, float p_pulse_width, float *p_output, int p_count) {
+	_render_voices_shape<false>(p_shape, r_group, p_lanes, p_pulse_width, p_output, nullptr, p_count);
+}
+
+void OscKernels::render_voices_stereo(Shape p_shape, VoiceGroup &r_group, int p_lanes, float p_pulse_width, float *p_left, float *p_right, int p_count) {
+	_render_voices_shape<true>(p_shape, r_group, p_lanes, p_pulse_width, p_left, p_right, p_count);
+}
+
+void OscKernels::render_wavetable(const float *p_table_a, const float *p_table_b, float p_morph, float p_morph_step, int p_table_size, float *p_output, int p_count, State &r_state) {
+	uint32_t phase = _phase_high(r_state.phase);
+	const uint32_t increment = _increment_high(r_state.increment);
+	float amplitude = r_state.amplitude;
+	const float amplitude_step = r_state.amplitude_step;
+	float morph = p_morph;
+
+	int i = 0;
+
+#ifdef OSC_KERNELS_SSE2
+	// No gathers in SSE2: indices are computed in vectors, the 16 loads are scalar, the math is vector again
+	__m128i phase4 = _mm_add_epi32(_mm_set1_epi32((int32_t)phase), _mm_set_epi32((int32_t)(3 * increment), (int32_t)(2 * increment), (int32_t)increment, 0));
+	const __m128i step = _mm_set1_epi32((int32_t)(4 * increment));
+	const __m128 size4 = _mm_set1_ps((float)p_table_size);
+	const __m128 morph_step4 = _mm_set1_ps(4.0f * p_morph_step);
+	__m128 morph4 = _mm_add_ps(_mm_set1_ps(morph), _mm_set_ps(3.0f * p_morph_step, 2.0f * p_morph_step, p_morph_step, 0.0f));
+	const __m128 amplitude_step4 = _mm_set1_ps(4.0f * amplitude_step);
+	__m128 amplitude4 = _mm_add_ps(_mm_set1_ps(amplitude), _mm_set_ps(3.0f * amplitude_step, 2.0f * amplitude_step, amplitude_step, 0.0f));
+	alignas(16) int32_t index[4];
+
+	for (; i + 4 <= p_count; i += 4) {
+		// At most size, which still reads the guard samples
+		__m128 position = _mm_mul_ps(_phase_to_float_sse2(phase4), size4);
+		__m128i whole = _mm_cvttps_epi32(position);
+		__m128 frac = _mm_sub_ps(position, _mm_cvtepi32_ps(whole));
+		_mm_store_si128((__m128i *)index, whole);
+
+		__m128 a0 = _mm_set_ps(p_table_a[index[3]], p_table_a[index[2]], p_table_a[index[1]], p_table_a[index[0]]);
+		__m128 a1 = _mm_set_ps(p_table_a[index[3] + 1], p_table_a[index[2] + 1], p_table_a[index[1] + 1], p_table_a[index[0] + 1]);
+		__m128 b0 = _mm_set_ps(p_table_b[index[3]], p_table_b[index[2]], p_table_b[index[1]], p_table_b[index[0]]);
+		__m128 b1 = _mm_set_ps(p_table_b[index[3] + 1], p_table_b[index[2] + 1], p_table_b[index[1] + 1], p_table_b[index[0] + 1]);
+
+		__m128 a = _mm_add_ps(a0, _mm_mul_ps(_mm_sub_ps(a1, a0), frac));
+		__m128 b = _mm_add_ps(b0, _mm_mul_ps(_mm_sub_ps(b1, b0), frac));
+		__m128 value = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), morph4));
+
+		_mm_storeu_ps(p_output + i, _mm_mul_ps(value, amplitude4));
+		amplitude4 = _mm_add_ps(amplitude4, amplitude_step4);
+		morph4 = _mm_add_ps(morph4, morph_step4);
+		phase4 = _mm_add_epi32(phase4, step);
+	}
+	phase += (uint32_t)i * increment;
+	amplitude += i * amplitude_step;
+	morph += i * p_morph_step;
+#endif
+
+	for (; i < p_count; i++) {
+		// Index and fraction straight from the fixed-point phase
+		uint64_t position = (uint64_t)phase * (uint32_t)p_table_size;
+		int index0 = (int)(position >> 32);
+		float frac = (float)(uint32_t)position * (float)(1.0 / OscKernels::PHASE_CYCLE);
+		float a = p_table_a[index0] + (p_table_a[index0 + 1] - p_table_a[index0]) * frac;
+		float b = p_table_b[index0] + (p_table_b[index0 + 1] - p_table_b[index0]) * frac;
+		p_output[i] = amplitude * (a + (b - a) * morph);
+		amplitude += amplitude_step;
+		morph += p_morph_step;
+		phase += increment;
+	}
+
+	r_state.phase += (uint64_t)p_count * r_state.increment;
+	r_state.amplitude = amplitude;
+}
+
+// Noise: xorshift32 per lane, white in [-1, 1) from the signed 32-bit value
+
+static const float NOISE_INT_TO_FLOAT = 1.0f / 2147483648.0f;
+
+// Paul Kellet's economy pink filter: three one-poles and a direct term, within 0.5 dB of
+// -3 dB/octave above ~10 Hz. Scaled to about the RMS of the brown noise.
+static const float PINK_POLE[3] = { 0.99765f, 0.96300f, 0.57000f };
+static const float PINK_GAIN[3] = { 0.0990460f, 0.2965164f, 1.0526913f };
+static const float PINK_DIRECT = 0.1848f;
+static const float PINK_SCALE = 0.1f;
+
+// Brown: a leaky integrator (a pure one would wander off), -6 dB/octave above ~20 Hz
+static const float BROWN_LEAK = 0.997f;
+static const float BROWN_GAIN = 0.03f;
+
+static inline uint32_t _xorshift(uint32_t &r_state) {
+	r_state ^= r_state << 13;
+	r_state ^= r_state >> 17;
+	r_state ^= r_state << 5;
+	return r_state;
+}
+
+template <OscKernels::NoiseColor C>
+static inline float _noise_scalar(float p_white, float *r_pink, float &r_brown) {
+	if constexpr (C == OscKernels::NOISE_WHITE) {
+		return p_white;
+	} else if constexpr (C == OscKernels::NOISE_PINK) {
+		float sum = PINK_DIRECT * p_white;
+		for (int p = 0; p < 3; p++) {
+			r_pink[p] = PINK_POLE[p] * r_pink[p] + PINK_GAIN[p] * p_white;
+			sum += r_pink[p];
+		}
+		return PINK_SCALE * sum;
+	} else {
+		r_brown = BROWN_LEAK * r_brown + BROWN_GAIN * p_white;
+		return r_brown;
+	}
+}
+
+#ifdef OSC_KERNELS_SSE2
+static inline __m128i _xorshift_sse2(__m128i p_state) {
+	p_state = _mm_xor_si128(p_state, _mm_slli_epi32(p_state, 13));
+	p_state = _mm_xor_si128(p_state, _mm_srli_epi32(p_state, 17));
+	return _mm_xor_si128(p_state, _mm_slli_epi32(p_state, 5));
+}
+
+// Coefficients of one one-pole filter for _one_pole_sse2()
+struct OnePoleSSE2 {
+	__m128 pole; // a
+	__m128 pole2; // a^2
+	__m128 powers; // a, a^2, a^3, a^4
+	__m128 gain;
+	__m128 last; // Previous output in every lane
+
+	OnePoleSSE2(float p_pole, float p_gain, float p_last) {
+		pole = _mm_set1_ps(p_pole);
+		pole2 = _mm_set1_ps(p_pole * p_pole);
+		powers = _mm_set_ps(p_pole * p_pole * p_pole * p_pole, p_pole * p_pole * p_pole, p_pole * p_pole, p_pole);
+		gain = _mm_set1_ps(p_gain);
+		last = _mm_set1_ps(p_last);
+	}
+};
+
+// y[k] = a * y[k - 1] + gain * x[k] for four consecutive samples: a prefix scan in two shifted
+// multiply-adds, then the previous output carried in with a^(k + 1). The serial dependency is one
+// multiply-add per four samples instead of four.
+static inline __m128 _one_pole_sse2(__m128 p_x, OnePoleSSE2 &r_filter) {
+	__m128 x = _mm_mul_ps(p_x, r_filter.gain);
+	x = _mm_add_ps(x, _mm_mul_ps(r_filter.pole, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4))));
+	x = _mm_add_ps(x, _mm_mul_ps(r_filter.pole2, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8))));
+	__m128 y = _mm_add_ps(x, _mm_mul_ps(r_filter.powers, r_filter.last));
+	r_filter.last = _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 3, 3));
+	return y;
+}
+
+static inline __m128 _pink_sse2(__m128 p_white, OnePoleSSE2 &r_pole_0, OnePoleSSE2 &r_pole_1, OnePoleSSE2 &r_pole_2) {
+	__m128 sum = _mm_mul_ps(p_white, _mm_set1_ps(PINK_DIRECT));
+	sum = _mm_add_ps(sum, _one_pole_sse2(p_white, r_pole_0));
+	sum = _mm_add_ps(sum, _one_pole_sse2(p_white, r_pole_1));
+	sum = _mm_add_ps(sum, _one_pole_sse2(p_white, r_pole_2));
+	return _mm_mul_ps(sum, _mm_set1_ps(PINK_SCALE));
+}
+#endif
+
+template <OscKernels::NoiseColor C>
+static void _render_noise(float *p_output, int p_count, OscKernels::NoiseState &r_noise, OscKernels::State &r_state) {
+	float amplitude = r_state.amplitude;
+	const float amplitude_step = r_state.amplitude_step;
+	int lane = r_noise.lane;
+	int i = 0;
+
+	// Single samples up to the next full step, so the sequence does not depend on the block sizes
+	for (; i < p_count && lane != 0; i++) {
+		float white = (float)(int32_t)_xorshift(r_noise.random[lane]) * NOISE_INT_TO_FLOAT;
+		p_output[i] = amplitude * _noise_scalar<C>(white, r_noise.pink, r_noise.brown);
+		amplitude += amplitude_step;
+		lane = (lane + 1) & (OscKernels::GROUP_SIZE - 1);
+	}
+
+#ifdef OSC_KERNELS_SSE2
+	if (i + 8 <= p_count) {
+		const int first = i;
+		const __m128 to_float = _mm_set1_ps(NOISE_INT_TO_FLOAT);
+		const __m128 amplitude_step8 = _mm_set1_ps(8.0f * amplitude_step);
+		__m128 amplitude_lo = _mm_add_ps(_mm_set1_ps(amplitude), _mm_mul_ps(_mm_set1_ps(amplitude_step), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)));
+		__m128 amplitude_hi = _mm_add_ps(_mm_set1_ps(amplitude), _mm_mul_ps(_mm_set1_ps(amplitude_step), _mm_set_ps(7.0f, 6.0f, 5.0f, 4.0f)));
+		__m128i random_lo = _mm_load_si128((const __m128i *)r_noise.random);
+		__m128i random_hi = _mm_load_si128((const __m128i *)(r_noise.random + 4));
+
+		// Separate variables rather than an array, so the filters stay in registers
+		OnePoleSSE2 pink_0(PINK_POLE[0], PINK_GAIN[0], r_noise.pink[0]);
+		OnePoleSSE2 pink_1(PINK_POLE[1], PINK_GAIN[1], r_noise.pink[1]);
+		OnePoleSSE2 pink_2(PINK_POLE[2], PINK_GAIN[2], r_noise.pink[2]);
+		OnePoleSSE2 brown(BROWN_LEAK, BROWN_GAIN, r_noise.brown);
+
+		for (; i + 8 <= p_count; i += 8) {
+			random_lo = _xorshift_sse2(random_lo);
+			random_hi = _xorshift_sse2(random_hi);
+			__m128 value_lo = _mm_mul_ps(_mm_cvtepi32_ps(random_lo), to_float);
+			__m128 value_hi = _mm_mul_ps(_mm_cvtepi32_ps(random_hi), to_float);
+			if constexpr (C == OscKernels::NOISE_PINK) {
+				value_lo = _pink_sse2(value_lo, pink_0, pink_1, pink_2);
+				value_hi = _pink_sse2(value_hi, pink_0, pink_1, pink_2);
+			} else if constexpr (C == OscKernels::NOISE_BROWN) {
+				value_lo = _one_pole_sse2(value_lo, brown);
+				value_hi = _one_pole_sse2(value_hi, brown);
+			}
+
+			_mm_storeu_ps(p_output + i, _mm_mul_ps(value_lo, amplitude_lo));
+			_mm_storeu_ps(p_output + i + 4, _mm_mul_ps(value_hi, amplitude_hi));
+			amplitude_lo = _mm_add_ps(amplitude_lo, amplitude_step8);
+			amplitude_hi = _mm_add_ps(amplitude_hi, amplitude_step8);
+		}
+
+		_mm_store_si128((__m128i *)r_noise.random, random_lo);
+		_mm_store_si128((__m128i *)(r_noise.random + 4), random_hi);
+		r_noise.pink[0] = _mm_cvtss_f32(pink_0.last);
+		r_noise.pink[1] = _mm_cvtss_f32(pink_1.last);
+		r_noise.pink[2] = _mm_cvtss_f32(pink_2.last);
+		r_noise.brown = _mm_cvtss_f32(brown.last);
+		amplitude += (i - first) * amplitude_step;
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		float white = (float)(int32_t)_xorshift(r_noise.random[lane]) * NOISE_INT_TO_FLOAT;
+		p_output[i] = amplitude * _noise_scalar<C>(white, r_noise.pink, r_noise.brown);
+		amplitude += amplitude_step;
+		lane = (lane + 1) & (OscKernels::GROUP_SIZE - 1);
+	}
+
+	r_noise.lane = lane;
+	r_state.amplitude = amplitude;
+}
+
+void OscKernels::seed_noise(NoiseState &r_noise, uint32_t p_seed) {
+	// splitmix32-style hash of (seed, lane), so neighbouring seeds and lanes are unrelated
+	for (int lane = 0; lane < GROUP_SIZE; lane++) {
+		uint32_t x = p_seed * (uint32_t)GROUP_SIZE + (uint32_t)lane + 0x9E3779B9u;
+		x = (x ^ (x >> 16)) * 0x85EBCA6Bu;
+		x = (x ^ (x >> 13)) * 0xC2B2AE35u;
+		x ^= x >> 16;
+		r_noise.random[lane] = x != 0 ? x : 0x6D2B79F5u;
+	}
+	r_noise.lane = 0;
+	for (int p = 0; p < 3; p++) {
+		r_noise.pink[p] = 0.0f;
+	}
+	r_noise.brown = 0.0f;
+}
+
+void OscKernels::render_noise(NoiseColor p_color, float *p_output, int p_count, NoiseState &r_noise, State &r_state) {
+	switch (p_color) {
+		case NOISE_WHITE:
+			_render_noise<NOISE_WHITE>(p_output, p_count, r_noise, r_state);
+			break;
+		case NOISE_PINK:
+			_render_noise<NOISE_PINK>(p_output, p_count, r_noise, r_state);
+			break;
+		case NOISE_BROWN:
+			_render_noise<NOISE_BROWN>(p_output, p_count, r_noise, r_state);
+			break;
+	}
+}
+
+void OscKernels::apply_gain(float *r_block, int p_count, float &r_gain, float p_mul, float p_add, float p_min, float p_max) {
+	float gain = r_gain;
+	int i = 0;
+
+	if (p_mul == 1.0f && p_add == 0.0f) {
+		// Held segment (sustain): a plain scale
+		for (; i < p_count; i++) {
+			r_block[i] *= gain;
+		}
+		return;
+	}
+
+#ifdef OSC_KERNELS_SSE2
+	// Closed form up to eight samples ahead: g[n + k] = g[n] * mul^k + add * (1 + mul + ... + mul^(k - 1)),
+	// so the serial recursion only steps once per eight samples. Segments are monotonic, so clamping
+	// the unrolled values gives the same result as clamping every step.
+	float powers[9];
+	float sums[9];
+	powers[0] = 1.0f;
+	sums[0] = 0.0f;
+	for (int k = 1; k <= 8; k++) {
+		powers[k] = powers[k - 1] * p_mul;
+		sums[k] = sums[k - 1] * p_mul + p_add;
+	}
+	const __m128 powers_lo = _mm_loadu_ps(powers);
+	const __m128 powers_hi = _mm_loadu_ps(powers + 4);
+	const __m128 sums_lo = _mm_loadu_ps(sums);
+	const __m128 sums_hi = _mm_loadu_ps(sums + 4);
+	const __m128 mul8 = _mm_set1_ps(powers[8]);
+	const __m128 add8 = _mm_set1_ps(sums[8]);
+	const __m128 gain_min = _mm_set1_ps(p_min);
+	const __m128 gain_max = _mm_set1_ps(p_max);
+	__m128 start = _mm_set1_ps(gain);
+	for (; i + 8 <= p_count; i += 8) {
+		__m128 gains_lo = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(start, powers_lo), sums_lo), gain_min), gain_max);
+		__m128 gains_hi = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(start, powers_hi), sums_hi), gain_min), gain_max);
+		_mm_storeu_ps(r_block + i, _mm_mul_ps(_mm_loadu_ps(r_block + i), gains_lo));
+		_mm_storeu_ps(r_block + i + 4, _mm_mul_ps(_mm_loadu_ps(r_block + i + 4), gains_hi));
+		start = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(start, mul8), add8), gain_min), gain_max);
+	}
+	gain = _mm_cvtss_f32(start);
+#endif
+
+	for (; i < p_count; i++) {
+		r_block[i] *= gain;
+		gain = gain * p_mul + p_add;
+		gain = gain < p_min ? p_min : (gain > p_max ? p_max : gain);
+	}
+	r_gain = gain;
+}
+
+void OscKernels::interleave_stereo(const float *p_left, const float *p_right, float *p_frames, int p_count) {
+	int i = 0;
+
+#ifdef OSC_KERNELS_SSE2
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 left = _mm_loadu_ps(p_left + i);
+		__m128 right = _mm_loadu_ps(p_right + i);
+		_mm_storeu_ps(p_frames + i * 2, _mm_unpacklo_ps(left, right));
+		_mm_storeu_ps(p_frames + i * 2 + 4, _mm_unpackhi_ps(left, right));
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		p_frames[i * 2] = p_left[i];
+		p_frames[i * 2 + 1] = p_right[i];
+	}
+}
+
+void OscKernels::splat_stereo(const float *p_mono, float *p_frames, int p_count) {
+	int i = 0;
+
+#ifdef OSC_KERNELS_SSE2
+	for (; i + 4 <= p_count; i += 4) {
+		__m128 mono = _mm_loadu_ps(p_mono + i);
+		_mm_storeu_ps(p_frames + i * 2, _mm_unpacklo_ps(mono, mono));
+		_mm_storeu_ps(p_frames + i * 2 + 4, _mm_unpackhi_ps(mono, mono));
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		p_frames[i * 2] = p_mono[i];
+		p_frames[i * 2 + 1] = p_mono[i];
+	}
+}
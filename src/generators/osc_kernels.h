@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*  osc_kernels.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             CIPHERS AUDIO                              */
+/*                        https://github.com/RiPCipher/CiphersAudio       */
+/**************************************************************************/
+
+#ifndef OSC_KERNELS_H
+#define OSC_KERNELS_H
+
+#include <cstdint>
+
+// Block renderers for the oscillators. Each shape has its own kernel (a template instance in
+// osc_kernels.cpp), so the per-sample loop has no branches on the waveform or parameter reads.
+// SSE2 is used where the build enables it, scalar code elsewhere.
+class OscKernels {
+public:
+	enum Shape {
+		SHAPE_SINE,
+		SHAPE_SAW,
+		SHAPE_SQUARE,
+		SHAPE_TRIANGLE,
+		SHAPE_PULSE,
+		// Band-limited: PolyBLEP at steps, PolyBLAMP at corners
+		SHAPE_SAW_BLEP,
+		SHAPE_SQUARE_BLEP,
+		SHAPE_TRIANGLE_BLAMP,
+		SHAPE_PULSE_BLEP,
+	};
+
+	// Phases are unsigned fixed-point fractions of a cycle, so they wrap by integer overflow. Kernels
+	// step 32-bit phases per sample (2^32 = one cycle). State keeps 32 more bits below those and
+	// advances the full 64 bits once per block, so a tone stays on its exact frequency however long
+	// it runs, without the 2^-32 cycle rounding of the per-sample step adding up.
+	static constexpr double PHASE_CYCLE = 4294967296.0;
+
+	// Cycles per sample -> 32-bit increment (VoiceGroup lanes), rounded
+	static uint32_t phase_increment(double p_cycles);
+	// Cycles per sample -> 64-bit increment (State)
+	static uint64_t phase_increment_64(double p_cycles);
+
+	// Oscillator state carried between blocks; render() advances phase and amplitude
+	struct State {
+		uint64_t phase = 0; // 2^64 = one cycle
+		uint64_t increment = 0; // Per sample, see phase_increment_64()
+		float amplitude = 0.0f;
+		float amplitude_step = 0.0f; // Per sample
+		float pulse_width = 0.5f; // SHAPE_PULSE*, fraction of the cycle at +1
+	};
+
+	static void render(Shape p_shape, float *p_output, int p_count, State &r_state);
+
+	// Voices advanced together by render_voices(), one per SIMD lane
+	static constexpr int GROUP_SIZE = 8;
+
+	// Lane arrays of one voice group. Lanes past the voice count must have zero gain and increment.
+	struct VoiceGroup {
+		alignas(32) uint32_t phase[GROUP_SIZE]; // Fixed point like State::phase
+		alignas(32) uint32_t increment[GROUP_SIZE];
+		alignas(32) float gain[GROUP_SIZE];
+		alignas(32) float gain_mul[GROUP_SIZE]; // Per sample: gain = gain * gain_mul + gain_step,
+		alignas(32) float gain_step[GROUP_SIZE]; // 1 and a step for linear ramps, a one-pole for exponential ones
+		alignas(32) float gain_min[GROUP_SIZE]; // The ramped gain is clamped to [gain_min, gain_max],
+		alignas(32) float gain_max[GROUP_SIZE]; // so a ramp holds exactly at its target once reached
+		alignas(32) float pan_left[GROUP_SIZE]; // Channel gains, render_voices_stereo() only
+		alignas(32) float pan_right[GROUP_SIZE];
+	};
+
+	enum SimdLevel {
+		SIMD_SCALAR,
+		SIMD_SSE2,
+		SIMD_AVX2, // x86-64 GCC/Clang builds only, picked at runtime when the CPU has it
+	};
+
+	static SimdLevel get_simd_level();
+	// Lowers the level used by render_voices() (benchmarks, tests); cannot go above what the CPU supports
+	static void set_simd_level(SimdLevel p_level);
+
+	// Adds the sum of the first p_lanes voices to p_output and advances their phases and gains.
+	// Each lane has its own frequency, so PolyBLEP widths are per lane as well.
+	static void render_voices(Shape p_shape, VoiceGroup &r_group, int p_lanes, float p_pulse_width, float *p_output, int p_count);
+
+	// Same, with every lane panned by pan_left / pan_right into two channel blocks
+	static void render_voices_stereo(Shape p_shape, VoiceGroup &r_group, int p_lanes, float p_pulse_width, float *p_left, float *p_right, int p_count);
+
+	// Linear interpolation inside two single-cycle tables of p_table_size + 2 samples (the two guard
+	// samples repeat the first two, so index + 1 never wraps), then a crossfade from A to B by p_morph,
+	// which moves by p_morph_step per sample
+	static void render_wavetable(const float *p_table_a, const float *p_table_b, float p_morph, float p_morph_step, int p_table_size, float *p_output, int p_count, State &r_state);
+
+	enum NoiseColor {
+		NOISE_WHITE,
+		NOISE_PINK, // -3 dB per octave
+		NOISE_BROWN, // -6 dB per octave
+	};
+
+	// Eight xorshift32 generators; sample n comes from lane n % 8, so one SIMD step makes eight
+	// consecutive samples. Also holds the pink and brown filter state.
+	struct NoiseState {
+		alignas(16) uint32_t random[GROUP_SIZE] = {}; // Never 0 once seeded
+		int lane = 0; // Lane of the next sample
+		float pink[3] = {};
+		float brown = 0.0f;
+	};
+
+	// The same seed always gives the same sequence; any value is valid
+	static void seed_noise(NoiseState &r_noise, uint32_t p_seed);
+
+	// Noise with the amplitude ramp of r_state (its phase is not used)
+	static void render_noise(NoiseColor p_color, float *p_output, int p_count, NoiseState &r_noise, State &r_state);
+
+	// Multiplies a block by a gain segment stepped like a VoiceGroup lane:
+	// gain = clamp(gain * p_mul + p_add, p_min, p_max) after every sample
+	static void apply_gain(float *r_block, int p_count, float &r_gain, float p_mul, float p_add, float p_min, float p_max);
+
+	// Two channel blocks -> interleaved stereo frames (AudioFrame layout)
+	static void interleave_stereo(const float *p_left, const float *p_right, float *p_frames, int p_count);
+
+	// Mono block -> interleaved stereo frames (AudioFrame layout)
+	static void splat_stereo(const float *p_mono, float *p_frames, int p_count);
+};
+
+#endif // OSC_KERNELS_H
@@ -15,7 +15,14 @@
 
 #include "fft/fft_buffer.h"
 #include "fft/fft_processor.h"
+#include "fft/spectrogram_writer.h"
+#include "fft/spectrum_bands.h"
+#include "fft/stft_processor.h"
 #include "generators/audio_stream_osc.h"
+#include "generators/audio_stream_synth.h"
+#include "generators/audio_stream_wavetable.h"
+#include "effects/audio_effect_cipher_convolution.h"
+#include "effects/audio_effect_cipher_spectrum.h"
 
 using namespace godot;
 
@@ -27,10 +34,23 @@ void initialize_pffft_module(ModuleInitializationLevel p_level) {
 	// FFT classes
 	ClassDB::register_class<FFTBuffer>();
 	ClassDB::register_class<FFTProcessor>();
+	ClassDB::register_class<STFTProcessor>();
+	ClassDB::register_class<SpectrumBands>();
+	ClassDB::register_class<SpectrogramWriter>();
 
 	// Generator classes
 	ClassDB::register_class<AudioStreamOsc>();
 	ClassDB::register_class<AudioStreamPlaybackOsc>();
+	ClassDB::register_class<AudioStreamWavetable>();
+	ClassDB::register_class<AudioStreamPlaybackWavetable>();
+	ClassDB::register_class<AudioStreamSynth>();
+	ClassDB::register_class<AudioStreamPlaybackSynth>();
+
+	// Effect classes
+	ClassDB::register_class<AudioEffectCipherSpectrum>();
+	ClassDB::register_class<AudioEffectCipherSpectrumInstance>();
+	ClassDB::register_class<AudioEffectCipherConvolution>();
+	ClassDB::register_class<AudioEffectCipherConvolutionInstance>();
 }
 
 void uninitialize_pffft_module(ModuleInitializationLevel p_level) {